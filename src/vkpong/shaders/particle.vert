@@ -0,0 +1,43 @@
+#version 450
+
+struct Particle {
+    vec2 position;
+    vec2 velocity;
+    float age;
+    float lifetime;
+    uint color;
+    uint padding;
+};
+
+layout(std430, binding = 0) readonly buffer Particles {
+    Particle data[];
+} particles;
+
+layout(std430, binding = 1) readonly buffer Alive {
+    uint data[];
+} alive;
+
+layout(push_constant) uniform Constants {
+    vec2 scale;
+} constants;
+
+const vec2 corners[6] = vec2[](
+    vec2(-1.0, -1.0),
+    vec2(1.0, -1.0),
+    vec2(1.0, 1.0),
+    vec2(1.0, 1.0),
+    vec2(-1.0, 1.0),
+    vec2(-1.0, -1.0));
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragCorner;
+
+void main() {
+    Particle particle = particles.data[alive.data[gl_InstanceIndex]];
+    vec2 corner = corners[gl_VertexIndex];
+
+    gl_Position = vec4(particle.position + corner * constants.scale, 0.0, 1.0);
+    fragColor = vec4(unpackUnorm4x8(particle.color).rgb,
+        1.0 - particle.age / particle.lifetime);
+    fragCorner = corner;
+}
@@ -1,7 +1,7 @@
 #version 450
 
 layout(location = 0) in vec3 fragColor;
-layout(location = 1) in vec2 inOffset;
+layout(location = 1) in vec2 inLocal;
 
 layout(location = 0) out vec4 outColor;
 
@@ -1,21 +1,53 @@
 #version 450
 
-layout(binding = 0) uniform UniformBufferObject {
-    mat4 model;
+layout(binding = 0) uniform Camera {
     mat4 view;
     mat4 proj;
-} ubo;
+} camera;
 
-layout(location = 0) in vec2 inPosition;
-layout(location = 1) in vec2 inOffset;
-layout(location = 2) in vec2 inDimensions;
-layout(location = 3) in vec3 inColor;
+// Full instances are tightly packed floats: center.xy, halfExtent.xy,
+// color.rgb. Packed instances are half float center and half extent
+// followed by an RGBA8 unorm color.
+layout(constant_id = 0) const bool packedInstances = false;
+
+layout(std430, set = 1, binding = 0) readonly buffer Instances {
+    uint data[];
+} instances;
+
+const vec2 corners[6] = vec2[](
+    vec2(-1.0, -1.0),
+    vec2(1.0, -1.0),
+    vec2(1.0, 1.0),
+    vec2(1.0, 1.0),
+    vec2(-1.0, 1.0),
+    vec2(-1.0, -1.0));
 
 layout(location = 0) out vec3 fragColor;
-layout(location = 1) out vec2 outOffset;
+layout(location = 1) out vec2 outLocal;
+
+float fetch(int index) {
+    return uintBitsToFloat(instances.data[index]);
+}
 
 void main() {
-    gl_Position = vec4(inPosition * inDimensions - inOffset, 0.0, 1.0);
-    fragColor = inColor;
-    outOffset = inOffset;
+    vec2 center;
+    vec2 halfExtent;
+    vec3 color;
+    if (packedInstances) {
+        int base = gl_InstanceIndex * 3;
+        center = unpackHalf2x16(instances.data[base]);
+        halfExtent = unpackHalf2x16(instances.data[base + 1]);
+        color = unpackUnorm4x8(instances.data[base + 2]).rgb;
+    } else {
+        int base = gl_InstanceIndex * 7;
+        center = vec2(fetch(base), fetch(base + 1));
+        halfExtent = vec2(fetch(base + 2), fetch(base + 3));
+        color = vec3(fetch(base + 4), fetch(base + 5), fetch(base + 6));
+    }
+
+    vec2 corner = corners[gl_VertexIndex];
+    gl_Position = camera.proj * camera.view *
+        vec4(corner * halfExtent + center, 0.0, 1.0);
+    fragColor = color;
+    outLocal = corner;
 }
@@ -0,0 +1,16 @@
+#version 450
+
+layout(binding = 1) uniform sampler2D atlas;
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    float distance = texture(atlas, fragTexCoord).r;
+    float width = fwidth(distance);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+
+    outColor = vec4(fragColor.rgb, fragColor.a * alpha);
+}
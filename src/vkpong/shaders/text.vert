@@ -0,0 +1,43 @@
+#version 450
+
+// Glyph instances: origin.xy, size, column, glyph, color.
+layout(std430, binding = 0) readonly buffer Glyphs {
+    uint data[];
+} glyphs;
+
+layout(push_constant) uniform Constants {
+    vec2 cellScale;
+    vec2 atlasCell;
+} constants;
+
+const vec2 corners[6] = vec2[](
+    vec2(0.0, 0.0),
+    vec2(1.0, 0.0),
+    vec2(1.0, 1.0),
+    vec2(1.0, 1.0),
+    vec2(0.0, 1.0),
+    vec2(0.0, 0.0));
+
+const int atlasColumns = 8;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+
+void main() {
+    int base = gl_InstanceIndex * 6;
+    vec2 origin = vec2(uintBitsToFloat(glyphs.data[base]),
+        uintBitsToFloat(glyphs.data[base + 1]));
+    float size = uintBitsToFloat(glyphs.data[base + 2]);
+    float column = float(glyphs.data[base + 3]);
+    int glyph = int(glyphs.data[base + 4]);
+
+    vec2 corner = corners[gl_VertexIndex];
+    vec2 cell = vec2(glyph % atlasColumns, glyph / atlasColumns);
+
+    gl_Position = vec4(
+        origin + (corner + vec2(column, 0.0)) * size * constants.cellScale,
+        0.0,
+        1.0);
+    fragColor = unpackUnorm4x8(glyphs.data[base + 5]);
+    fragTexCoord = (cell + corner) * constants.atlasCell;
+}
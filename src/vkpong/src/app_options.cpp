@@ -0,0 +1,109 @@
+#include <app_options.hpp>
+
+#include <fmt/format.h>
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+namespace
+{
+    [[nodiscard]] uint32_t parse_number(std::string_view const name,
+        std::string_view const value)
+    {
+        uint32_t rv{};
+        auto const [end, error]{
+            std::from_chars(value.data(), value.data() + value.size(), rv)};
+        if (error != std::errc{} || end != value.data() + value.size() ||
+            rv == 0)
+        {
+            throw std::runtime_error{
+                fmt::format("invalid value '{}' for {}", value, name)};
+        }
+
+        return rv;
+    }
+} // namespace
+
+vkpong::app_options vkpong::parse_options(std::span<char* const> const args)
+{
+    app_options rv;
+
+    for (size_t i{1}; i < args.size(); ++i)
+    {
+        std::string_view const arg{args[i]};
+        if (arg == "--headless")
+        {
+            rv.headless = true;
+        }
+        else if (arg == "--statistics")
+        {
+            rv.statistics = true;
+        }
+        else if (arg == "--overdraw")
+        {
+            rv.overdraw = true;
+        }
+        else if (arg == "--benchmark-quality")
+        {
+            rv.benchmark_quality = true;
+        }
+        else if (arg == "--benchmark-instances")
+        {
+            rv.benchmark_instances = true;
+        }
+        else if (arg == "--benchmark-shader-objects")
+        {
+            rv.benchmark_shader_objects = true;
+        }
+        else if (arg == "--validate-particles")
+        {
+            rv.validate_particles = true;
+        }
+        else if (arg == "--dynamic-resolution")
+        {
+            rv.dynamic_resolution = true;
+        }
+        else if (arg == "--screenshot" && i + 1 < args.size())
+        {
+            rv.screenshot = args[++i];
+        }
+        else if (arg == "--capture" && i + 1 < args.size())
+        {
+            rv.capture = args[++i];
+        }
+        else if ((arg == "--frames" || arg == "--width" ||
+                     arg == "--height" || arg == "--frame-budget-us") &&
+            i + 1 < args.size())
+        {
+            uint32_t const value{parse_number(arg, args[++i])};
+            if (arg == "--frames")
+            {
+                rv.frames = value;
+            }
+            else if (arg == "--frame-budget-us")
+            {
+                rv.frame_budget_us = value;
+            }
+            else if (arg == "--width")
+            {
+                rv.width = value;
+            }
+            else
+            {
+                rv.height = value;
+            }
+        }
+        else
+        {
+            throw std::runtime_error{
+                fmt::format("unrecognized argument '{}'", arg)};
+        }
+    }
+
+    return rv;
+}
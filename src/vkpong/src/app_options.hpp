@@ -0,0 +1,34 @@
+#ifndef VKPONG_APP_OPTIONS_INCLUDED
+#define VKPONG_APP_OPTIONS_INCLUDED
+
+#include <window.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace vkpong
+{
+    struct [[nodiscard]] app_options final
+    {
+        bool headless{};
+        uint32_t frames{1000};
+        uint32_t width{window::default_width};
+        uint32_t height{window::default_height};
+        std::filesystem::path screenshot;
+        std::filesystem::path capture;
+        bool statistics{};
+        bool overdraw{};
+        bool benchmark_quality{};
+        bool benchmark_instances{};
+        bool benchmark_shader_objects{};
+        bool validate_particles{};
+        bool dynamic_resolution{};
+        uint32_t frame_budget_us{};
+    };
+
+    // Throws on unrecognized arguments and invalid values.
+    app_options parse_options(std::span<char* const> args);
+} // namespace vkpong
+
+#endif // !VKPONG_APP_OPTIONS_INCLUDED
@@ -0,0 +1,262 @@
+#include <benchmarks.hpp>
+
+#include <device_allocator.hpp>
+#include <diagnostics.hpp>
+#include <headless_app.hpp>
+#include <particle_system.hpp>
+#include <quad_batcher.hpp>
+#include <vulkan_device.hpp>
+#include <vulkan_offscreen_target.hpp>
+#include <vulkan_render_target.hpp>
+#include <vulkan_renderer.hpp>
+#include <vulkan_utility.hpp>
+
+#include <fmt/format.h>
+#include <glm/glm.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    constexpr std::array benchmark_instance_counts{1'000u,
+        10'000u,
+        50'000u,
+        100'000u};
+
+    [[nodiscard]] std::string_view instance_format_name(
+        vkpong::quad_instance_format const format)
+    {
+        return format == vkpong::quad_instance_format::packed ? "packed"
+                                                              : "full";
+    }
+
+    // Fills the screen with a grid of small circles on top of the game.
+    void submit_benchmark_instances(vkpong::quad_batcher& batcher,
+        uint32_t const count)
+    {
+        auto const columns{static_cast<uint32_t>(
+            std::ceil(std::sqrt(static_cast<float>(count))))};
+        float const spacing{2.0f / static_cast<float>(columns)};
+        glm::fvec2 const radii{spacing * 0.4f};
+
+        for (uint32_t i{}; i != count; ++i)
+        {
+            auto const column{static_cast<float>(i % columns)};
+            auto const row{static_cast<float>(i / columns)};
+            glm::fvec2 const center{-1.0f + spacing * (column + 0.5f),
+                -1.0f + spacing * (row + 0.5f)};
+            batcher.add_circle(center,
+                radii,
+                {column * spacing / 2.0f, row * spacing / 2.0f, 0.5f});
+        }
+    }
+
+    [[nodiscard]] std::string quality_name(
+        vkpong::render_quality const& quality)
+    {
+        return fmt::format("{}x{}{}",
+            static_cast<uint32_t>(quality.samples),
+            quality.sample_shading ? " sample shading" : "",
+            quality.shader_objects ? " shader objects" : "");
+    }
+} // namespace
+
+void vkpong::benchmark_quality(headless_app& app, uint32_t const frames)
+{
+    using clock = std::chrono::steady_clock;
+
+    vulkan_device const& device{app.device()};
+    vulkan_renderer& renderer{app.renderer()};
+
+    for (VkSampleCountFlagBits const samples : msaa_sample_counts)
+    {
+        if (samples > device.max_msaa_samples())
+        {
+            break;
+        }
+
+        for (bool const sample_shading : {false, true})
+        {
+            render_quality const quality{.samples = samples,
+                .sample_shading = sample_shading};
+
+            // Quality change is applied at the end of the warm up frame, which
+            // also resets the profiler history.
+            renderer.set_quality(quality);
+            app.draw_frame();
+
+            auto const start{clock::now()};
+            for (uint32_t i{}; i != frames; ++i)
+            {
+                app.draw_frame();
+            }
+            vkDeviceWaitIdle(device.logical());
+            std::chrono::duration<double> const elapsed{clock::now() - start};
+
+            spdlog::info("{}: {:.1f} FPS, GPU {:.3f} ms per frame",
+                quality_name(renderer.quality()),
+                frames / elapsed.count(),
+                total_gpu_time(renderer.profiler()));
+        }
+    }
+}
+
+void vkpong::benchmark_instances(headless_app& app, uint32_t const frames)
+{
+    using clock = std::chrono::steady_clock;
+
+    vulkan_device const& device{app.device()};
+    vulkan_renderer& renderer{app.renderer()};
+
+    for (uint32_t const count : benchmark_instance_counts)
+    {
+        for (quad_instance_format const format :
+            {quad_instance_format::full, quad_instance_format::packed})
+        {
+            render_quality quality{renderer.quality()};
+            quality.instance_format = format;
+            renderer.set_quality(quality);
+
+            // Warm up frames apply the format and grow the frame ring to fit
+            // the instances of all frames in flight.
+            for (uint32_t i{}; i != vulkan_render_target::max_frames_in_flight;
+                 ++i)
+            {
+                submit_benchmark_instances(renderer.batcher(), count);
+                app.draw_frame();
+            }
+
+            auto const start{clock::now()};
+            for (uint32_t i{}; i != frames; ++i)
+            {
+                submit_benchmark_instances(renderer.batcher(), count);
+                app.draw_frame();
+            }
+            vkDeviceWaitIdle(device.logical());
+            std::chrono::duration<double> const elapsed{clock::now() - start};
+
+            spdlog::info("{} instances, {} format, {} KiB per frame: "
+                         "{:.1f} FPS, GPU {:.3f} ms per frame",
+                count,
+                instance_format_name(format),
+                count * instance_size(format) / 1024,
+                frames / elapsed.count(),
+                total_gpu_time(renderer.profiler()));
+        }
+    }
+}
+
+void vkpong::benchmark_shader_objects(headless_app& app,
+    uint32_t const frames)
+{
+    vulkan_device const& device{app.device()};
+    vulkan_renderer& renderer{app.renderer()};
+
+    for (bool const shader_objects : {false, true})
+    {
+        if (shader_objects && !renderer.shader_objects_supported())
+        {
+            spdlog::warn("Shader objects not supported");
+            break;
+        }
+
+        render_quality quality{renderer.quality()};
+        quality.shader_objects = shader_objects;
+        renderer.set_quality(quality);
+        app.draw_frame();
+
+        std::chrono::nanoseconds record{};
+        for (uint32_t i{}; i != frames; ++i)
+        {
+            app.draw_frame();
+            record += renderer.last_frame_timings().record;
+        }
+        vkDeviceWaitIdle(device.logical());
+
+        std::chrono::duration<double, std::milli> const build{
+            renderer.quad_pipeline_build_time()};
+        std::chrono::duration<double, std::micro> const recording{
+            record / std::max(frames, 1u)};
+        spdlog::info("{}: build {:.3f} ms, record {:.1f} us, "
+                     "GPU {:.3f} ms per frame",
+            shader_objects ? "Shader objects" : "Pipelines",
+            build.count(),
+            recording.count(),
+            total_gpu_time(renderer.profiler()));
+    }
+}
+
+bool vkpong::validate_particles(headless_app& app, uint32_t const steps)
+{
+    vulkan_device& device{app.device()};
+    vulkan_offscreen_target const& target{app.target()};
+
+    constexpr uint32_t capacity{uint32_t{1} << 16};
+    constexpr float delta_time{1.0f / 60.0f};
+
+    particle_system gpu{&device, target.graphics_queue(), capacity};
+    cpu_particle_system cpu{capacity};
+
+    for (uint32_t step{}; step != steps; ++step)
+    {
+        if (step % 10 == 0)
+        {
+            float const angle{static_cast<float>(step) * 0.1f};
+            particle_burst const burst{
+                .position = {std::cos(angle) * 0.5f, std::sin(angle) * 0.5f},
+                .direction = {std::sin(angle), std::cos(angle)},
+                .speed = 0.8f,
+                .spread = 2.5f,
+                .lifetime = 1.0f,
+                .color = {1.0f, 0.5f, 0.25f},
+                .count = 4096 + step % 3 * 1000};
+            gpu.emit(burst);
+            cpu.emit(burst);
+        }
+
+        submit_one_time(device.logical(),
+            device.graphics_family(),
+            target.graphics_queue(),
+            [&](VkCommandBuffer const command_buffer)
+            {
+                gpu.record_update(command_buffer,
+                    step % vulkan_render_target::max_frames_in_flight,
+                    delta_time);
+                // Emitters are written while recording.
+                device.allocator().flush_pending();
+            });
+        cpu.update(delta_time);
+
+        particle_snapshot const snapshot{
+            gpu.read_back(target.graphics_queue())};
+        if (snapshot.alive_count != cpu.alive_count())
+        {
+            spdlog::error("Step {}: {} particles alive, expected {}",
+                step,
+                snapshot.alive_count,
+                cpu.alive_count());
+            return false;
+        }
+
+        auto const expected{cpu.particles()};
+        for (size_t i{}; i != expected.size(); ++i)
+        {
+            if (!particles_match(snapshot.particles[i], expected[i]))
+            {
+                spdlog::error("Step {}: particle {} differs", step, i);
+                return false;
+            }
+        }
+    }
+
+    spdlog::info("Particles match the reference after {} steps", steps);
+    return true;
+}
@@ -0,0 +1,30 @@
+#ifndef VKPONG_BENCHMARKS_INCLUDED
+#define VKPONG_BENCHMARKS_INCLUDED
+
+#include <cstdint>
+
+namespace vkpong
+{
+    class headless_app;
+} // namespace vkpong
+
+namespace vkpong
+{
+    // Frame rate and GPU time of each supported MSAA and sample shading
+    // combination.
+    void benchmark_quality(headless_app& app, uint32_t frames);
+
+    // Frame rate and GPU time of a screen filling grid of circles in both
+    // instance formats.
+    void benchmark_instances(headless_app& app, uint32_t frames);
+
+    // Compares creation time of the quad pipelines against shader objects
+    // and the CPU time of recording frames bound with each.
+    void benchmark_shader_objects(headless_app& app, uint32_t frames);
+
+    // Runs the compute particle system in lockstep with the CPU reference
+    // implementation and compares the results after every step.
+    [[nodiscard]] bool validate_particles(headless_app& app, uint32_t steps);
+} // namespace vkpong
+
+#endif // !VKPONG_BENCHMARKS_INCLUDED
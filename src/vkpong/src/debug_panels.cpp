@@ -0,0 +1,295 @@
+#include <debug_panels.hpp>
+
+#include <device_allocator.hpp>
+#include <diagnostics.hpp>
+#include <host_allocator.hpp>
+#include <quad_batcher.hpp>
+#include <resolution_scaler.hpp>
+#include <vulkan_device.hpp>
+#include <vulkan_profiler.hpp>
+#include <vulkan_renderer.hpp>
+
+#include <fmt/format.h>
+#include <imgui.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace
+{
+    void show_quality(vkpong::vulkan_renderer& renderer,
+        VkSampleCountFlagBits const max_samples)
+    {
+        vkpong::render_quality quality{renderer.quality()};
+
+        if (ImGui::BeginCombo("MSAA",
+                fmt::format("{}x", static_cast<uint32_t>(quality.samples))
+                    .c_str()))
+        {
+            for (VkSampleCountFlagBits const samples :
+                vkpong::msaa_sample_counts)
+            {
+                if (samples > max_samples)
+                {
+                    break;
+                }
+
+                if (ImGui::Selectable(
+                        fmt::format("{}x", static_cast<uint32_t>(samples))
+                            .c_str(),
+                        samples == quality.samples))
+                {
+                    quality.samples = samples;
+                }
+            }
+            ImGui::EndCombo();
+        }
+
+        ImGui::Checkbox("Sample shading", &quality.sample_shading);
+
+        bool packed{
+            quality.instance_format == vkpong::quad_instance_format::packed};
+        if (ImGui::Checkbox("Packed instances", &packed))
+        {
+            quality.instance_format = packed
+                ? vkpong::quad_instance_format::packed
+                : vkpong::quad_instance_format::full;
+        }
+
+        if (renderer.dynamic_resolution_supported())
+        {
+            ImGui::Checkbox("Dynamic resolution", &quality.dynamic_resolution);
+        }
+
+        if (renderer.shader_objects_supported())
+        {
+            ImGui::Checkbox("Shader objects", &quality.shader_objects);
+        }
+
+        if (quality != renderer.quality())
+        {
+            renderer.set_quality(quality);
+        }
+
+        if (renderer.quality().dynamic_resolution)
+        {
+            vkpong::resolution_scaler& scaler{renderer.scaler()};
+
+            auto budget{static_cast<float>(scaler.budget())};
+            if (ImGui::SliderFloat("Budget ms", &budget, 1.0f, 33.3f, "%.1f"))
+            {
+                scaler.set_budget(budget);
+            }
+
+            ImGui::Text("Scale %.2f, GPU %.3f ms",
+                static_cast<double>(scaler.scale()),
+                scaler.smoothed_time());
+        }
+    }
+
+    void show_statistics(vkpong::vulkan_profiler const& profiler,
+        VkExtent2D const extent)
+    {
+        if (!ImGui::BeginTable("statistics", 4, ImGuiTableFlags_Borders))
+        {
+            return;
+        }
+
+        ImGui::TableSetupColumn("Pass");
+        ImGui::TableSetupColumn("Primitives");
+        ImGui::TableSetupColumn("Fragments");
+        ImGui::TableSetupColumn("Per pixel");
+        ImGui::TableHeadersRow();
+
+        double const pixels{
+            static_cast<double>(extent.width) * extent.height};
+        for (size_t i{}; i != profiler.pass_count(); ++i)
+        {
+            vkpong::pass_statistics const statistics{profiler.statistics(i)};
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(profiler.pass_name(i).data());
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu",
+                static_cast<unsigned long long>(
+                    statistics.clipping_primitives));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu",
+                static_cast<unsigned long long>(
+                    statistics.fragment_invocations));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f",
+                static_cast<double>(statistics.fragment_invocations) /
+                    pixels);
+        }
+        ImGui::EndTable();
+    }
+
+    void show_host_allocations(
+        vkpong::host_allocation_statistics const& statistics)
+    {
+        ImGui::Separator();
+        ImGui::TextUnformatted("Host allocations");
+        if (ImGui::BeginTable("host_allocations", 5))
+        {
+            ImGui::TableSetupColumn("Scope");
+            ImGui::TableSetupColumn("Allocs/frame");
+            ImGui::TableSetupColumn("KiB/frame");
+            ImGui::TableSetupColumn("Live");
+            ImGui::TableSetupColumn("Live KiB");
+            ImGui::TableHeadersRow();
+
+            for (size_t i{}; i != vkpong::host_scope_names.size(); ++i)
+            {
+                vkpong::host_scope_statistics const& scope{
+                    statistics.scopes[i]};
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(vkpong::host_scope_names[i]);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu",
+                    static_cast<unsigned long long>(scope.frame_allocations));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f",
+                    static_cast<double>(scope.frame_allocated_bytes) /
+                        vkpong::kibibyte);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu",
+                    static_cast<unsigned long long>(scope.live_allocations));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f",
+                    static_cast<double>(scope.live_bytes) / vkpong::kibibyte);
+            }
+            ImGui::EndTable();
+        }
+        ImGui::Text("Command scope from arena: %llu",
+            static_cast<unsigned long long>(
+                statistics.frame_arena_allocations));
+    }
+} // namespace
+
+void vkpong::show_profiler(vulkan_renderer& renderer,
+    VkSampleCountFlagBits const max_samples,
+    VkExtent2D const extent)
+{
+    vulkan_profiler& profiler{renderer.profiler()};
+
+    ImGui::Begin("GPU timings", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+    if (!profiler.enabled())
+    {
+        ImGui::TextUnformatted("Timestamp queries are not supported");
+    }
+    else if (ImGui::BeginTable("passes", 5, ImGuiTableFlags_Borders))
+    {
+        ImGui::TableSetupColumn("Pass");
+        ImGui::TableSetupColumn("Avg ms");
+        ImGui::TableSetupColumn("p50 ms");
+        ImGui::TableSetupColumn("p95 ms");
+        ImGui::TableSetupColumn("p99 ms");
+        ImGui::TableHeadersRow();
+
+        for (size_t i{}; i != profiler.pass_count(); ++i)
+        {
+            pass_timings const timings{profiler.timings(i)};
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(profiler.pass_name(i).data());
+            for (double const value :
+                {timings.average, timings.p50, timings.p95, timings.p99})
+            {
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", value);
+            }
+        }
+        ImGui::EndTable();
+    }
+
+    show_quality(renderer, max_samples);
+
+    bool overdraw{renderer.overdraw_view()};
+    if (ImGui::Checkbox("Overdraw heat map", &overdraw))
+    {
+        renderer.set_overdraw_view(overdraw);
+    }
+
+    if (profiler.statistics_supported())
+    {
+        bool statistics{profiler.statistics_enabled()};
+        if (ImGui::Checkbox("Pipeline statistics", &statistics))
+        {
+            profiler.set_statistics_enabled(statistics);
+        }
+
+        if (statistics)
+        {
+            show_statistics(profiler, extent);
+        }
+    }
+    ImGui::End();
+}
+
+void vkpong::show_memory(vulkan_device const& device)
+{
+    device_allocator_statistics const& statistics{
+        device.allocator().statistics()};
+
+    ImGui::Begin("Device memory", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+    if (!device.memory_budget_supported())
+    {
+        ImGui::TextUnformatted(
+            "VK_EXT_memory_budget not supported, showing own usage");
+    }
+
+    std::span<heap_budget const> const heaps{device.memory_budget()};
+    for (uint32_t i{}; i != heaps.size(); ++i)
+    {
+        heap_budget const& heap{heaps[i]};
+        double const fraction{heap.budget == 0
+                ? 0.0
+                : static_cast<double>(heap.usage) /
+                    static_cast<double>(heap.budget)};
+
+        ImGui::Text("Heap %u%s: %.1f MiB",
+            i,
+            heap.device_local ? " (device local)" : "",
+            to_mebibytes(heap.size));
+        std::string const overlay{fmt::format("{:.1f} / {:.1f} MiB",
+            to_mebibytes(heap.usage),
+            to_mebibytes(heap.budget))};
+        ImGui::ProgressBar(static_cast<float>(fraction),
+            ImVec2{300.0f, 0.0f},
+            overlay.c_str());
+        ImGui::Text("Allocator blocks: %.2f MiB, other: %.2f MiB",
+            to_mebibytes(statistics.heap_reserved_bytes[i]),
+            to_mebibytes(other_memory_usage(device, i)));
+    }
+
+    ImGui::Separator();
+    for (size_t i{}; i != allocation_category_names.size(); ++i)
+    {
+        ImGui::Text("%s: %.2f MiB",
+            allocation_category_names[i],
+            to_mebibytes(statistics.category_bytes[i]));
+    }
+
+    ImGui::Separator();
+    ImGui::Text("Allocations: %zu", statistics.allocations);
+    ImGui::Text("Allocated: %.2f MiB",
+        to_mebibytes(statistics.allocated_bytes));
+    ImGui::Text("Blocks: %zu, %.2f MiB",
+        statistics.blocks,
+        to_mebibytes(statistics.reserved_bytes));
+    ImGui::Text("vkAllocateMemory calls: %llu",
+        static_cast<unsigned long long>(statistics.device_allocations));
+    ImGui::Text("vkFlushMappedMemoryRanges calls: %llu",
+        static_cast<unsigned long long>(statistics.flushes));
+
+    show_host_allocations(default_host_allocator().statistics());
+    ImGui::End();
+}
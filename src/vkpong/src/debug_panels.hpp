@@ -0,0 +1,24 @@
+#ifndef VKPONG_DEBUG_PANELS_INCLUDED
+#define VKPONG_DEBUG_PANELS_INCLUDED
+
+#include <vulkan/vulkan_core.h>
+
+namespace vkpong
+{
+    class vulkan_device;
+    class vulkan_renderer;
+} // namespace vkpong
+
+namespace vkpong
+{
+    // GPU pass timings and render quality controls, must be called between
+    // ImGui::NewFrame and the draw of the frame.
+    void show_profiler(vulkan_renderer& renderer,
+        VkSampleCountFlagBits max_samples,
+        VkExtent2D extent);
+
+    // Heap budgets and device and host allocator statistics.
+    void show_memory(vulkan_device const& device);
+} // namespace vkpong
+
+#endif // !VKPONG_DEBUG_PANELS_INCLUDED
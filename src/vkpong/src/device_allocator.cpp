@@ -0,0 +1,456 @@
+#include <device_allocator.hpp>
+
+#include <host_allocator.hpp>
+#include <vulkan_utility.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    [[nodiscard]] uint32_t order_of(VkDeviceSize const size)
+    {
+        VkDeviceSize const ranges{std::bit_ceil(size) /
+            vkpong::device_allocator::min_allocation_size};
+        return static_cast<uint32_t>(std::countr_zero(ranges));
+    }
+
+    [[nodiscard]] VkDeviceSize size_of(uint32_t const order)
+    {
+        return vkpong::device_allocator::min_allocation_size << order;
+    }
+} // namespace
+
+vkpong::device_allocator::device_allocator(VkDevice const device,
+    VkPhysicalDeviceMemoryProperties const& memory_properties,
+    VkDeviceSize const non_coherent_atom_size)
+    : device_{device}
+    , memory_properties_{memory_properties}
+    , non_coherent_atom_size_{non_coherent_atom_size}
+{
+}
+
+vkpong::device_allocator::~device_allocator()
+{
+    assert(statistics_.allocations == 0);
+
+    for (memory_block const& block : blocks_)
+    {
+        if (block.memory != VK_NULL_HANDLE)
+        {
+            vkFreeMemory(device_, block.memory, allocation_callbacks());
+        }
+    }
+}
+
+vkpong::device_allocation vkpong::device_allocator::allocate_with_type(
+    VkMemoryRequirements const& requirements,
+    uint32_t const memory_type,
+    allocation_tiling const tiling,
+    allocation_category const category,
+    VkImage const image)
+{
+    assert(requirements.memoryTypeBits & (1u << memory_type));
+
+    device_allocation rv{.size = requirements.size, .category = category};
+
+    size_t block{blocks_.size()};
+    if (requirements.size > block_size)
+    {
+        // Rounding up to a power of two would waste up to half of it.
+        block = create_block(memory_type,
+            tiling,
+            requirements.size,
+            true,
+            image);
+    }
+    else
+    {
+        // Buddy ranges are aligned to their size, alignment is a power of
+        // two.
+        rv.order = order_of(std::max({requirements.size,
+            requirements.alignment,
+            min_allocation_size}));
+
+        for (size_t i{}; i != blocks_.size(); ++i)
+        {
+            memory_block& candidate{blocks_[i]};
+            if (candidate.memory != VK_NULL_HANDLE && !candidate.dedicated &&
+                candidate.memory_type == memory_type &&
+                candidate.tiling == tiling &&
+                candidate.free_lists.size() > rv.order &&
+                allocate_from(candidate, rv.order, rv.offset))
+            {
+                block = i;
+                break;
+            }
+        }
+
+        if (block == blocks_.size())
+        {
+            block = create_block(memory_type,
+                tiling,
+                block_size,
+                false,
+                VK_NULL_HANDLE);
+
+            [[maybe_unused]] bool const allocated{
+                allocate_from(blocks_[block], rv.order, rv.offset)};
+            assert(allocated);
+        }
+    }
+
+    rv.block = block;
+    VkDeviceSize const reserved{reserved_size(rv)};
+
+    memory_block& owner{blocks_[block]};
+    owner.used += reserved;
+
+    rv.memory = owner.memory;
+    if (owner.mapped)
+    {
+        rv.mapped = owner.mapped + rv.offset;
+        VkMemoryPropertyFlags const flags{
+            memory_properties_.memoryTypes[memory_type].propertyFlags};
+        rv.coherent = (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+    }
+
+    ++statistics_.allocations;
+    statistics_.allocated_bytes += reserved;
+    statistics_.category_bytes[std::to_underlying(category)] += reserved;
+
+    return rv;
+}
+
+vkpong::device_allocation vkpong::device_allocator::allocate(
+    VkMemoryRequirements const& requirements,
+    memory_preference const& preference,
+    allocation_tiling const tiling,
+    allocation_category const category,
+    VkImage const image)
+{
+    std::optional<uint32_t> const memory_type{select_memory_type(
+        memory_properties_,
+        requirements.memoryTypeBits,
+        preference)};
+    if (!memory_type)
+    {
+        throw std::runtime_error{"failed to find suitable memory type!"};
+    }
+
+    return allocate_with_type(requirements,
+        *memory_type,
+        tiling,
+        category,
+        image);
+}
+
+void vkpong::device_allocator::free(device_allocation const& allocation)
+{
+    if (allocation.memory == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    memory_block& block{blocks_[allocation.block]};
+    assert(block.memory == allocation.memory);
+
+    VkDeviceSize const reserved{reserved_size(allocation)};
+    if (!allocation.coherent)
+    {
+        VkDeviceSize const end{allocation.offset + reserved};
+        std::erase_if(pending_flushes_,
+            [&allocation, end](VkMappedMemoryRange const& range)
+            {
+                return range.memory == allocation.memory &&
+                    range.offset >= allocation.offset && range.offset < end;
+            });
+    }
+
+    block.used -= reserved;
+    --statistics_.allocations;
+    statistics_.allocated_bytes -= reserved;
+    statistics_.category_bytes[std::to_underlying(allocation.category)] -=
+        reserved;
+
+    if (block.dedicated)
+    {
+        release_block(allocation.block);
+        return;
+    }
+
+    // Merge with free buddies for as long as they are free.
+    VkDeviceSize offset{allocation.offset};
+    uint32_t order{allocation.order};
+    for (; order + 1 < block.free_lists.size(); ++order)
+    {
+        std::vector<VkDeviceSize>& free_list{block.free_lists[order]};
+        auto const buddy{
+            std::ranges::find(free_list, offset ^ size_of(order))};
+        if (buddy == free_list.end())
+        {
+            break;
+        }
+
+        offset = std::min(offset, *buddy);
+        free_list.erase(buddy);
+    }
+    block.free_lists[order].push_back(offset);
+
+    if (block.used == 0)
+    {
+        release_spare_block(allocation.block);
+    }
+}
+
+void vkpong::device_allocator::flush(device_allocation const& allocation,
+    VkDeviceSize const offset,
+    VkDeviceSize const size)
+{
+    if (allocation.coherent || size == 0)
+    {
+        return;
+    }
+
+    pending_flushes_.push_back(atom_aligned_range(allocation, offset, size));
+}
+
+void vkpong::device_allocator::flush_pending()
+{
+    if (pending_flushes_.empty())
+    {
+        return;
+    }
+
+    // Ring buffers queue many adjacent ranges, merge them.
+    std::ranges::sort(pending_flushes_,
+        [](VkMappedMemoryRange const& lhs, VkMappedMemoryRange const& rhs)
+        {
+            return std::pair{lhs.memory, lhs.offset} <
+                std::pair{rhs.memory, rhs.offset};
+        });
+
+    size_t merged{};
+    for (size_t i{1}; i != pending_flushes_.size(); ++i)
+    {
+        VkMappedMemoryRange& last{pending_flushes_[merged]};
+        VkMappedMemoryRange const& next{pending_flushes_[i]};
+        if (next.memory == last.memory &&
+            next.offset <= last.offset + last.size)
+        {
+            last.size = std::max(last.offset + last.size,
+                            next.offset + next.size) -
+                last.offset;
+        }
+        else
+        {
+            pending_flushes_[++merged] = next;
+        }
+    }
+    pending_flushes_.resize(merged + 1);
+
+    if (vkFlushMappedMemoryRanges(device_,
+            count_cast(pending_flushes_.size()),
+            pending_flushes_.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to flush mapped memory!"};
+    }
+
+    ++statistics_.flushes;
+    pending_flushes_.clear();
+}
+
+void vkpong::device_allocator::invalidate(
+    device_allocation const& allocation,
+    VkDeviceSize const offset,
+    VkDeviceSize const size) const
+{
+    if (allocation.coherent || size == 0)
+    {
+        return;
+    }
+
+    VkMappedMemoryRange const range{
+        atom_aligned_range(allocation, offset, size)};
+    if (vkInvalidateMappedMemoryRanges(device_, 1, &range) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to invalidate mapped memory!"};
+    }
+}
+
+VkMappedMemoryRange vkpong::device_allocator::atom_aligned_range(
+    device_allocation const& allocation,
+    VkDeviceSize const offset,
+    VkDeviceSize const size) const
+{
+    // Suballocations are aligned to at least min_allocation_size, which
+    // is the largest atom size allowed, widening the range keeps it inside
+    // the allocation. A dedicated allocation may end inside an atom, its
+    // range is clamped to the end of the memory.
+    static_assert(min_allocation_size >= 256);
+    VkDeviceSize const reserved{reserved_size(allocation)};
+    assert(offset + size <= reserved);
+
+    VkDeviceSize const begin{allocation.offset + offset};
+    VkDeviceSize const aligned_begin{
+        begin / non_coherent_atom_size_ * non_coherent_atom_size_};
+    VkDeviceSize const aligned_end{
+        std::min((begin + size + non_coherent_atom_size_ - 1) /
+                non_coherent_atom_size_ * non_coherent_atom_size_,
+            allocation.offset + reserved)};
+
+    VkMappedMemoryRange rv{};
+    rv.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    rv.memory = allocation.memory;
+    rv.offset = aligned_begin;
+    rv.size = aligned_end - aligned_begin;
+    return rv;
+}
+
+bool vkpong::device_allocator::allocate_from(memory_block& block,
+    uint32_t const order,
+    VkDeviceSize& offset)
+{
+    auto const available{std::find_if(
+        std::next(block.free_lists.begin(), order),
+        block.free_lists.end(),
+        [](std::vector<VkDeviceSize> const& free_list)
+        { return !free_list.empty(); })};
+    if (available == block.free_lists.end())
+    {
+        return false;
+    }
+
+    auto current{
+        static_cast<uint32_t>(std::distance(block.free_lists.begin(),
+            available))};
+    offset = available->back();
+    available->pop_back();
+
+    // Split the range, keeping the lower half and freeing the upper one.
+    while (current != order)
+    {
+        --current;
+        block.free_lists[current].push_back(offset + size_of(current));
+    }
+
+    return true;
+}
+
+size_t vkpong::device_allocator::create_block(uint32_t const memory_type,
+    allocation_tiling const tiling,
+    VkDeviceSize const size,
+    bool const dedicated,
+    VkImage const image)
+{
+    VkMemoryAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    alloc_info.allocationSize = size;
+    alloc_info.memoryTypeIndex = memory_type;
+
+    VkMemoryDedicatedAllocateInfo dedicated_info{};
+    dedicated_info.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    dedicated_info.image = image;
+    if (dedicated && image != VK_NULL_HANDLE)
+    {
+        alloc_info.pNext = &dedicated_info;
+    }
+
+    memory_block block{.memory_type = memory_type,
+        .tiling = tiling,
+        .size = size,
+        .dedicated = dedicated};
+    if (vkAllocateMemory(device_,
+            &alloc_info,
+            allocation_callbacks(),
+            &block.memory) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to allocate device memory!"};
+    }
+
+    if (memory_properties_.memoryTypes[memory_type].propertyFlags &
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        void* mapped{};
+        if (vkMapMemory(device_, block.memory, 0, size, 0, &mapped) !=
+            VK_SUCCESS)
+        {
+            vkFreeMemory(device_, block.memory, allocation_callbacks());
+            throw std::runtime_error{"unable to map memory!"};
+        }
+        block.mapped = static_cast<std::byte*>(mapped);
+    }
+
+    if (!dedicated)
+    {
+        uint32_t const max_order{order_of(size)};
+        block.free_lists.resize(max_order + 1);
+        block.free_lists[max_order].push_back(0);
+    }
+
+    ++statistics_.blocks;
+    ++statistics_.device_allocations;
+    statistics_.reserved_bytes += size;
+    statistics_.heap_reserved_bytes[heap_of(memory_type)] += size;
+
+    auto slot{std::ranges::find(blocks_,
+        VkDeviceMemory{VK_NULL_HANDLE},
+        &memory_block::memory)};
+    if (slot == blocks_.end())
+    {
+        slot = blocks_.insert(slot, memory_block{});
+    }
+    *slot = std::move(block);
+
+    return static_cast<size_t>(std::distance(blocks_.begin(), slot));
+}
+
+void vkpong::device_allocator::release_spare_block(size_t const block)
+{
+    // Keep a single empty block of each memory type for reuse.
+    memory_block const& empty{blocks_[block]};
+    bool const spare_exists{std::ranges::any_of(blocks_,
+        [&empty](memory_block const& other)
+        {
+            return &other != &empty && other.memory != VK_NULL_HANDLE &&
+                !other.dedicated && other.used == 0 &&
+                other.memory_type == empty.memory_type &&
+                other.tiling == empty.tiling;
+        })};
+    if (spare_exists)
+    {
+        release_block(block);
+    }
+}
+
+void vkpong::device_allocator::release_block(size_t const block)
+{
+    memory_block const& released{blocks_[block]};
+
+    // Mapped memory is implicitly unmapped when freed.
+    vkFreeMemory(device_, released.memory, allocation_callbacks());
+
+    --statistics_.blocks;
+    statistics_.reserved_bytes -= released.size;
+    statistics_.heap_reserved_bytes[heap_of(released.memory_type)] -=
+        released.size;
+
+    blocks_[block] = {};
+}
+
+VkDeviceSize vkpong::device_allocator::reserved_size(
+    device_allocation const& allocation) const
+{
+    memory_block const& block{blocks_[allocation.block]};
+    return block.dedicated ? block.size : size_of(allocation.order);
+}
+
+uint32_t vkpong::device_allocator::heap_of(uint32_t const memory_type) const
+{
+    return memory_properties_.memoryTypes[memory_type].heapIndex;
+}
@@ -0,0 +1,191 @@
+#ifndef VKPONG_DEVICE_ALLOCATOR_INCLUDED
+#define VKPONG_DEVICE_ALLOCATOR_INCLUDED
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkpong
+{
+    struct memory_preference;
+} // namespace vkpong
+
+namespace vkpong
+{
+    // Buffers and linearly tiled images are linear resources, they are
+    // never placed into the same block as optimally tiled images.
+    enum class [[nodiscard]] allocation_tiling : uint8_t
+    {
+        linear,
+        optimal
+    };
+
+    enum class [[nodiscard]] allocation_category : uint8_t
+    {
+        buffer,
+        image,
+        staging
+    };
+
+    inline constexpr size_t allocation_category_count{3};
+
+    struct [[nodiscard]] device_allocation final
+    {
+        VkDeviceMemory memory{};
+        VkDeviceSize offset{};
+        VkDeviceSize size{};
+        // Start of the allocation, null unless the memory is host visible.
+        std::byte* mapped{};
+        // Host writes and device writes need no explicit flush and
+        // invalidate.
+        bool coherent{true};
+        allocation_category category{};
+        size_t block{};
+        uint32_t order{};
+    };
+
+    struct [[nodiscard]] device_allocator_statistics final
+    {
+        size_t blocks{};
+        size_t allocations{};
+        VkDeviceSize reserved_bytes{};
+        VkDeviceSize allocated_bytes{};
+        uint64_t device_allocations{};
+        uint64_t flushes{};
+        // Allocated bytes, suballocations include rounding to a power of
+        // two.
+        std::array<VkDeviceSize, allocation_category_count> category_bytes{};
+        std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> heap_reserved_bytes{};
+    };
+
+    // Suballocates large device memory blocks with a buddy allocator, an
+    // allocation is its size and alignment rounded up to a power of two.
+    // Requests larger than a block get a dedicated allocation of their
+    // exact size instead. Host visible blocks stay mapped for their whole
+    // lifetime.
+    class [[nodiscard]] device_allocator final
+    {
+    public: // Constants
+        static constexpr VkDeviceSize block_size{VkDeviceSize{64} << 20};
+        static constexpr VkDeviceSize min_allocation_size{256};
+
+    public: // Construction
+        device_allocator(VkDevice device,
+            VkPhysicalDeviceMemoryProperties const& memory_properties,
+            VkDeviceSize non_coherent_atom_size);
+
+        device_allocator(device_allocator const&) = delete;
+
+        device_allocator(device_allocator&&) noexcept = delete;
+
+    public: // Destruction
+        ~device_allocator();
+
+    public: // Interface
+        // Image is the image the memory will be bound to, if any, it is
+        // passed to the driver when the allocation is dedicated.
+        [[nodiscard]] device_allocation allocate_with_type(
+            VkMemoryRequirements const& requirements,
+            uint32_t memory_type,
+            allocation_tiling tiling,
+            allocation_category category,
+            VkImage image = VK_NULL_HANDLE);
+
+        [[nodiscard]] device_allocation allocate(
+            VkMemoryRequirements const& requirements,
+            memory_preference const& preference,
+            allocation_tiling tiling,
+            allocation_category category,
+            VkImage image = VK_NULL_HANDLE);
+
+        // Resources bound to the allocation must already be destroyed.
+        void free(device_allocation const& allocation);
+
+        // Queues a host written range of a non coherent allocation for the
+        // next flush_pending call, offset is relative to the allocation.
+        void flush(device_allocation const& allocation,
+            VkDeviceSize offset,
+            VkDeviceSize size);
+
+        // Flushes all queued ranges with a single call, must precede the
+        // submission reading them.
+        void flush_pending();
+
+        // Makes device writes to a non coherent allocation visible to the
+        // host. Doesn't touch allocator state, it may be called from other
+        // threads.
+        void invalidate(device_allocation const& allocation,
+            VkDeviceSize offset,
+            VkDeviceSize size) const;
+
+        [[nodiscard]] constexpr device_allocator_statistics const&
+        statistics() const noexcept;
+
+    public: // Operators
+        device_allocator& operator=(device_allocator const&) = delete;
+
+        device_allocator& operator=(device_allocator&&) noexcept = delete;
+
+    private: // Types
+        struct [[nodiscard]] memory_block final
+        {
+            VkDeviceMemory memory{};
+            uint32_t memory_type{};
+            allocation_tiling tiling{};
+            VkDeviceSize size{};
+            VkDeviceSize used{};
+            std::byte* mapped{};
+            // Holds a single allocation and is freed with it.
+            bool dedicated{};
+            // Offsets of free ranges of min_allocation_size << order bytes,
+            // indexed by order.
+            std::vector<std::vector<VkDeviceSize>> free_lists;
+        };
+
+    private: // Helpers
+        [[nodiscard]] VkMappedMemoryRange atom_aligned_range(
+            device_allocation const& allocation,
+            VkDeviceSize offset,
+            VkDeviceSize size) const;
+
+        [[nodiscard]] bool allocate_from(memory_block& block,
+            uint32_t order,
+            VkDeviceSize& offset);
+
+        [[nodiscard]] size_t create_block(uint32_t memory_type,
+            allocation_tiling tiling,
+            VkDeviceSize size,
+            bool dedicated,
+            VkImage image);
+
+        void release_spare_block(size_t block);
+
+        void release_block(size_t block);
+
+        // Bytes of the block taken by the allocation.
+        [[nodiscard]] VkDeviceSize reserved_size(
+            device_allocation const& allocation) const;
+
+        [[nodiscard]] uint32_t heap_of(uint32_t memory_type) const;
+
+    private: // Data
+        VkDevice device_;
+        VkPhysicalDeviceMemoryProperties memory_properties_{};
+        VkDeviceSize non_coherent_atom_size_;
+
+        std::vector<memory_block> blocks_;
+        std::vector<VkMappedMemoryRange> pending_flushes_;
+        device_allocator_statistics statistics_;
+    };
+} // namespace vkpong
+
+inline constexpr vkpong::device_allocator_statistics const&
+vkpong::device_allocator::statistics() const noexcept
+{
+    return statistics_;
+}
+
+#endif // !VKPONG_DEVICE_ALLOCATOR_INCLUDED
@@ -0,0 +1,159 @@
+#include <diagnostics.hpp>
+
+#include <frame_readback.hpp>
+#include <vulkan_device.hpp>
+#include <vulkan_profiler.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <span>
+
+namespace
+{
+    // Usage above this fraction of the budget is logged as a warning, the
+    // driver may start paging memory out of the heap beyond the budget.
+    constexpr double memory_budget_warning{0.9};
+} // namespace
+
+double vkpong::to_mebibytes(VkDeviceSize const bytes)
+{
+    return static_cast<double>(bytes) / mebibyte;
+}
+
+VkDeviceSize vkpong::other_memory_usage(vulkan_device const& device,
+    uint32_t const heap)
+{
+    if (!device.memory_budget_supported())
+    {
+        return 0;
+    }
+
+    VkDeviceSize const usage{device.memory_budget()[heap].usage};
+    VkDeviceSize const reserved{
+        device.allocator().statistics().heap_reserved_bytes[heap]};
+    return usage > reserved ? usage - reserved : 0;
+}
+
+void vkpong::log_memory(vulkan_device const& device)
+{
+    device_allocator_statistics const& statistics{
+        device.allocator().statistics()};
+
+    std::span<heap_budget const> const heaps{device.memory_budget()};
+    for (uint32_t i{}; i != heaps.size(); ++i)
+    {
+        heap_budget const& heap{heaps[i]};
+        if (heap.usage == 0)
+        {
+            continue;
+        }
+
+        double const fraction{static_cast<double>(heap.usage) /
+            static_cast<double>(heap.budget)};
+        spdlog::log(fraction > memory_budget_warning
+                ? spdlog::level::warn
+                : spdlog::level::info,
+            "Heap {}: {:.1f} of {:.1f} MiB budget ({:.0f}%), "
+            "allocator {:.1f} MiB, other {:.1f} MiB",
+            i,
+            to_mebibytes(heap.usage),
+            to_mebibytes(heap.budget),
+            fraction * 100.0,
+            to_mebibytes(statistics.heap_reserved_bytes[i]),
+            to_mebibytes(other_memory_usage(device, i)));
+    }
+
+    spdlog::info("Allocated: buffers {:.1f} MiB, images {:.1f} MiB, "
+                 "staging {:.1f} MiB",
+        to_mebibytes(statistics.category_bytes[0]),
+        to_mebibytes(statistics.category_bytes[1]),
+        to_mebibytes(statistics.category_bytes[2]));
+
+    // Steady state frames should not allocate on the host at all.
+    host_allocation_statistics const& host{
+        default_host_allocator().statistics()};
+    for (size_t i{}; i != host_scope_names.size(); ++i)
+    {
+        host_scope_statistics const& scope{host.scopes[i]};
+        if (scope.frame_allocations == 0 && scope.live_allocations == 0)
+        {
+            continue;
+        }
+
+        spdlog::info("Host {} scope: {} allocations, {:.1f} KiB in the "
+                     "last frame, {} live, {:.1f} KiB",
+            host_scope_names[i],
+            scope.frame_allocations,
+            static_cast<double>(scope.frame_allocated_bytes) / kibibyte,
+            scope.live_allocations,
+            static_cast<double>(scope.live_bytes) / kibibyte);
+    }
+}
+
+void vkpong::log_gpu_timings(vulkan_profiler const& profiler)
+{
+    if (!profiler.enabled())
+    {
+        return;
+    }
+
+    for (size_t i{}; i != profiler.pass_count(); ++i)
+    {
+        pass_timings const timings{profiler.timings(i)};
+        spdlog::info("GPU {}: avg {:.3f} ms, p50 {:.3f} ms, "
+                     "p95 {:.3f} ms, p99 {:.3f} ms",
+            profiler.pass_name(i),
+            timings.average,
+            timings.p50,
+            timings.p95,
+            timings.p99);
+    }
+}
+
+double vkpong::total_gpu_time(vulkan_profiler const& profiler)
+{
+    double rv{};
+    for (size_t i{}; i != profiler.pass_count(); ++i)
+    {
+        rv += profiler.timings(i).average;
+    }
+    return rv;
+}
+
+void vkpong::log_statistics(vulkan_profiler const& profiler,
+    VkExtent2D const extent)
+{
+    if (!profiler.statistics_enabled())
+    {
+        return;
+    }
+
+    double const pixels{static_cast<double>(extent.width) * extent.height};
+    for (size_t i{}; i != profiler.pass_count(); ++i)
+    {
+        pass_statistics const statistics{profiler.statistics(i)};
+        spdlog::info("{}: {} primitives, {} fragments, {:.2f} per pixel",
+            profiler.pass_name(i),
+            statistics.clipping_primitives,
+            statistics.fragment_invocations,
+            static_cast<double>(statistics.fragment_invocations) / pixels);
+    }
+}
+
+void vkpong::save_screenshot(std::filesystem::path const& path,
+    readback_image const& image)
+{
+    try
+    {
+        write_ppm(path, image);
+        spdlog::info("Saved frame {} to {}", image.frame, path.string());
+    }
+    catch (std::exception const& ex)
+    {
+        spdlog::error("Unable to save screenshot: {}", ex.what());
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef VKPONG_DIAGNOSTICS_INCLUDED
+#define VKPONG_DIAGNOSTICS_INCLUDED
+
+#include <device_allocator.hpp>
+#include <host_allocator.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+
+namespace vkpong
+{
+    class vulkan_device;
+    class vulkan_profiler;
+
+    struct readback_image;
+} // namespace vkpong
+
+namespace vkpong
+{
+    inline constexpr double kibibyte{1024.0};
+
+    inline constexpr double mebibyte{1024.0 * 1024.0};
+
+    inline constexpr std::array<char const*, allocation_category_count>
+        allocation_category_names{"Buffers", "Images", "Staging"};
+
+    // Indexed by VkSystemAllocationScope.
+    inline constexpr std::array<char const*, host_scope_count>
+        host_scope_names{"Command", "Object", "Cache", "Device", "Instance"};
+
+    [[nodiscard]] double to_mebibytes(VkDeviceSize bytes);
+
+    // Memory of the process not coming from the device allocator, ImGui
+    // buffers and textures and driver internal allocations.
+    [[nodiscard]] VkDeviceSize other_memory_usage(vulkan_device const& device,
+        uint32_t heap);
+
+    void log_memory(vulkan_device const& device);
+
+    void log_gpu_timings(vulkan_profiler const& profiler);
+
+    // Sum of the average times of all passes in milliseconds.
+    [[nodiscard]] double total_gpu_time(vulkan_profiler const& profiler);
+
+    void log_statistics(vulkan_profiler const& profiler, VkExtent2D extent);
+
+    // Logs instead of throwing when the file can't be written.
+    void save_screenshot(std::filesystem::path const& path,
+        readback_image const& image);
+} // namespace vkpong
+
+#endif // !VKPONG_DIAGNOSTICS_INCLUDED
@@ -0,0 +1,54 @@
+#include <dynamic_uniform_buffer.hpp>
+
+#include <vulkan_device.hpp>
+#include <vulkan_utility.hpp>
+
+#include <stdexcept>
+
+namespace
+{
+    [[nodiscard]] VkDeviceSize slice_stride(
+        vkpong::vulkan_device const* const device,
+        VkDeviceSize const slice_size)
+    {
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(device->physical(), &properties);
+
+        // The alignment is guaranteed to be a power of two.
+        VkDeviceSize const alignment{
+            properties.limits.minUniformBufferOffsetAlignment};
+        return (slice_size + alignment - 1) & ~(alignment - 1);
+    }
+} // namespace
+
+vkpong::dynamic_uniform_buffer::dynamic_uniform_buffer(
+    vulkan_device* const device,
+    VkDeviceSize const slice_size,
+    size_t const slices_per_frame)
+    : slice_size_{slice_size}
+    , stride_{slice_stride(device, slice_size)}
+    , slices_per_frame_{slices_per_frame}
+    , buffer_{device,
+          stride_ * slices_per_frame *
+              vulkan_render_target::max_frames_in_flight,
+          VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+          dynamic_memory}
+{
+}
+
+void vkpong::dynamic_uniform_buffer::begin_frame(uint32_t const frame)
+{
+    frame_ = frame;
+    used_ = 0;
+}
+
+uint32_t vkpong::dynamic_uniform_buffer::allocate()
+{
+    if (used_ == slices_per_frame_)
+    {
+        throw std::runtime_error{"uniform buffer frame region exhausted!"};
+    }
+
+    size_t const slice{size_t{frame_} * slices_per_frame_ + used_++};
+    return count_cast(slice * stride_);
+}
@@ -0,0 +1,112 @@
+#ifndef VKPONG_DYNAMIC_UNIFORM_BUFFER_INCLUDED
+#define VKPONG_DYNAMIC_UNIFORM_BUFFER_INCLUDED
+
+#include <gpu_layout.hpp>
+#include <mapped_span.hpp>
+#include <vulkan_buffer.hpp>
+#include <vulkan_render_target.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace vkpong
+{
+    class vulkan_device;
+} // namespace vkpong
+
+namespace vkpong
+{
+    // One uniform buffer shared by all frame slots and bound through a
+    // single dynamic uniform buffer descriptor. Each frame slot owns a
+    // region of slices aligned to the minimum uniform buffer offset
+    // alignment, uniforms of a frame are bumped into the region of its
+    // slot and addressed by dynamic offset. Slices are allocated in the
+    // same order every frame, the first slice of a frame always has the
+    // same offset.
+    class [[nodiscard]] dynamic_uniform_buffer final
+    {
+    public: // Constants
+        static constexpr size_t default_slices_per_frame{64};
+
+    public: // Construction
+        dynamic_uniform_buffer(vulkan_device* device,
+            VkDeviceSize slice_size,
+            size_t slices_per_frame = default_slices_per_frame);
+
+        dynamic_uniform_buffer(dynamic_uniform_buffer const&) = delete;
+
+        dynamic_uniform_buffer(dynamic_uniform_buffer&&) noexcept = delete;
+
+    public: // Destruction
+        ~dynamic_uniform_buffer() = default;
+
+    public: // Interface
+        // The previous use of the frame slot must have completed on the
+        // device.
+        void begin_frame(uint32_t frame);
+
+        // Dynamic offset of the next free slice of the current frame.
+        [[nodiscard]] uint32_t allocate();
+
+        template<std140_layout T>
+        [[nodiscard]] mapped_span<T> slice(uint32_t offset);
+
+        template<std140_layout T>
+        [[nodiscard]] uint32_t push(T const& value);
+
+        [[nodiscard]] constexpr VkBuffer buffer() const noexcept;
+
+        // Range of the descriptor, every dynamic offset addresses a range
+        // of this size.
+        [[nodiscard]] constexpr VkDeviceSize slice_size() const noexcept;
+
+    public: // Operators
+        dynamic_uniform_buffer& operator=(
+            dynamic_uniform_buffer const&) = delete;
+
+        dynamic_uniform_buffer& operator=(
+            dynamic_uniform_buffer&&) noexcept = delete;
+
+    private: // Data
+        VkDeviceSize slice_size_;
+        VkDeviceSize stride_;
+        size_t slices_per_frame_;
+        vulkan_buffer buffer_;
+        uint32_t frame_{};
+        size_t used_{};
+    };
+} // namespace vkpong
+
+template<vkpong::std140_layout T>
+vkpong::mapped_span<T> vkpong::dynamic_uniform_buffer::slice(
+    uint32_t const offset)
+{
+    assert(sizeof(T) <= slice_size_);
+
+    return {buffer_, offset, 1};
+}
+
+template<vkpong::std140_layout T>
+uint32_t vkpong::dynamic_uniform_buffer::push(T const& value)
+{
+    uint32_t const rv{allocate()};
+    slice<T>(rv).emplace_back(value);
+    return rv;
+}
+
+inline constexpr VkBuffer
+vkpong::dynamic_uniform_buffer::buffer() const noexcept
+{
+    return buffer_.buffer();
+}
+
+inline constexpr VkDeviceSize
+vkpong::dynamic_uniform_buffer::slice_size() const noexcept
+{
+    return slice_size_;
+}
+
+#endif // !VKPONG_DYNAMIC_UNIFORM_BUFFER_INCLUDED
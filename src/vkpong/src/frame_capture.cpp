@@ -0,0 +1,204 @@
+#include <frame_capture.hpp>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    constexpr size_t texel_size{4};
+
+    [[nodiscard]] std::byte luma(int const r, int const g, int const b)
+    {
+        return static_cast<std::byte>((77 * r + 150 * g + 29 * b + 128) >> 8);
+    }
+
+    [[nodiscard]] std::byte chroma_blue(int const r, int const g, int const b)
+    {
+        return static_cast<std::byte>(
+            ((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128);
+    }
+
+    [[nodiscard]] std::byte chroma_red(int const r, int const g, int const b)
+    {
+        return static_cast<std::byte>(
+            ((128 * r - 107 * g - 21 * b + 128) >> 8) + 128);
+    }
+} // namespace
+
+vkpong::frame_capture::frame_capture(std::filesystem::path const& path,
+    VkExtent2D const extent,
+    uint32_t const frame_rate,
+    size_t const pool_size)
+    : path_{path}
+    , extent_{extent}
+    , stream_{path, std::ios::binary}
+{
+    if (!stream_.is_open())
+    {
+        throw std::runtime_error{"failed to open capture file!"};
+    }
+
+    std::string const header{
+        fmt::format("YUV4MPEG2 W{} H{} F{}:1 Ip A1:1 C420jpeg\n",
+            extent_.width,
+            extent_.height,
+            frame_rate)};
+    stream_.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    size_t const width{extent_.width};
+    size_t const height{extent_.height};
+    size_t const chroma_size{((width + 1) / 2) * ((height + 1) / 2)};
+    planes_.resize(width * height + 2 * chroma_size);
+
+    pool_.resize(pool_size);
+    for (size_t i{}; i != pool_size; ++i)
+    {
+        pool_[i].pixels.resize(width * height * texel_size);
+        free_.push_back(i);
+    }
+
+    writer_ = std::jthread{
+        [this](std::stop_token const& token) { write(token); }};
+}
+
+vkpong::frame_capture::~frame_capture()
+{
+    writer_.request_stop();
+    writer_.join();
+
+    spdlog::info("Captured {} frames to {}, dropped {}",
+        written_frames(),
+        path_.string(),
+        dropped_frames());
+}
+
+void vkpong::frame_capture::push(readback_image const& image)
+{
+    if (image.extent.width != extent_.width ||
+        image.extent.height != extent_.height)
+    {
+        dropped_frames_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    size_t index{};
+    {
+        std::scoped_lock const lock{mutex_};
+        if (free_.empty())
+        {
+            dropped_frames_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        index = free_.back();
+        free_.pop_back();
+    }
+
+    pooled_frame& frame{pool_[index]};
+    std::ranges::copy(image.pixels.first(frame.pixels.size()),
+        frame.pixels.begin());
+    frame.bgra = has_bgra_layout(image.format);
+
+    {
+        std::scoped_lock const lock{mutex_};
+        ready_.push_back(index);
+    }
+    condition_.notify_one();
+}
+
+void vkpong::frame_capture::write(std::stop_token const& token)
+{
+    constexpr std::string_view frame_header{"FRAME\n"};
+
+    while (true)
+    {
+        size_t index{};
+        {
+            std::unique_lock lock{mutex_};
+            if (!condition_.wait(lock,
+                    token,
+                    [this]() { return !ready_.empty(); }))
+            {
+                return;
+            }
+
+            index = ready_.front();
+            ready_.pop_front();
+        }
+
+        convert(pool_[index]);
+
+        {
+            std::scoped_lock const lock{mutex_};
+            free_.push_back(index);
+        }
+
+        stream_.write(frame_header.data(),
+            static_cast<std::streamsize>(frame_header.size()));
+        // NOLINTNEXTLINE
+        stream_.write(reinterpret_cast<char const*>(planes_.data()),
+            static_cast<std::streamsize>(planes_.size()));
+
+        written_frames_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void vkpong::frame_capture::convert(pooled_frame const& frame)
+{
+    size_t const width{extent_.width};
+    size_t const height{extent_.height};
+    size_t const chroma_width{(width + 1) / 2};
+    size_t const chroma_height{(height + 1) / 2};
+
+    std::span<std::byte> const planes{planes_};
+    auto const y_plane{planes.first(width * height)};
+    auto const u_plane{
+        planes.subspan(width * height, chroma_width * chroma_height)};
+    auto const v_plane{planes.last(chroma_width * chroma_height)};
+
+    size_t const r_offset{frame.bgra ? 2u : 0u};
+    size_t const b_offset{frame.bgra ? 0u : 2u};
+    auto const channel = [&frame](size_t const texel, size_t const offset)
+    {
+        return std::to_integer<int>(frame.pixels[texel * texel_size + offset]);
+    };
+
+    for (size_t cy{}; cy != chroma_height; ++cy)
+    {
+        for (size_t cx{}; cx != chroma_width; ++cx)
+        {
+            int r_sum{};
+            int g_sum{};
+            int b_sum{};
+            int count{};
+            for (size_t y{cy * 2}; y != std::min(cy * 2 + 2, height); ++y)
+            {
+                for (size_t x{cx * 2}; x != std::min(cx * 2 + 2, width); ++x)
+                {
+                    size_t const texel{y * width + x};
+                    int const r{channel(texel, r_offset)};
+                    int const g{channel(texel, 1)};
+                    int const b{channel(texel, b_offset)};
+
+                    y_plane[texel] = luma(r, g, b);
+                    r_sum += r;
+                    g_sum += g;
+                    b_sum += b;
+                    ++count;
+                }
+            }
+
+            size_t const chroma_texel{cy * chroma_width + cx};
+            u_plane[chroma_texel] =
+                chroma_blue(r_sum / count, g_sum / count, b_sum / count);
+            v_plane[chroma_texel] =
+                chroma_red(r_sum / count, g_sum / count, b_sum / count);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef VKPONG_FRAME_CAPTURE_INCLUDED
+#define VKPONG_FRAME_CAPTURE_INCLUDED
+
+#include <frame_readback.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace vkpong
+{
+    // Streams frames into a Y4M file. Frames are copied into a fixed pool of
+    // preallocated buffers, if the writer falls behind they are dropped.
+    class [[nodiscard]] frame_capture final
+    {
+    public: // Constants
+        static constexpr uint32_t default_frame_rate{60};
+
+    public: // Construction
+        frame_capture(std::filesystem::path const& path,
+            VkExtent2D extent,
+            uint32_t frame_rate,
+            size_t pool_size = 8);
+
+        frame_capture(frame_capture const&) = delete;
+
+        frame_capture(frame_capture&&) noexcept = delete;
+
+    public: // Destruction
+        ~frame_capture();
+
+    public: // Interface
+        void push(readback_image const& image);
+
+        [[nodiscard]] uint64_t written_frames() const noexcept;
+
+        [[nodiscard]] uint64_t dropped_frames() const noexcept;
+
+    public: // Operators
+        frame_capture& operator=(frame_capture const&) = delete;
+
+        frame_capture& operator=(frame_capture&&) noexcept = delete;
+
+    private: // Types
+        struct [[nodiscard]] pooled_frame final
+        {
+            std::vector<std::byte> pixels;
+            bool bgra{};
+        };
+
+    private: // Helpers
+        void write(std::stop_token const& token);
+
+        void convert(pooled_frame const& frame);
+
+    private: // Data
+        std::filesystem::path path_;
+        VkExtent2D extent_;
+        std::ofstream stream_;
+
+        std::vector<pooled_frame> pool_;
+        std::vector<std::byte> planes_;
+
+        std::mutex mutex_;
+        std::condition_variable_any condition_;
+        std::vector<size_t> free_;
+        std::deque<size_t> ready_;
+
+        std::atomic<uint64_t> written_frames_{};
+        std::atomic<uint64_t> dropped_frames_{};
+
+        std::jthread writer_;
+    };
+} // namespace vkpong
+
+inline uint64_t vkpong::frame_capture::written_frames() const noexcept
+{
+    return written_frames_.load(std::memory_order_relaxed);
+}
+
+inline uint64_t vkpong::frame_capture::dropped_frames() const noexcept
+{
+    return dropped_frames_.load(std::memory_order_relaxed);
+}
+
+#endif // !VKPONG_FRAME_CAPTURE_INCLUDED
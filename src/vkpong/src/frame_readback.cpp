@@ -0,0 +1,245 @@
+#include <frame_readback.hpp>
+
+#include <host_allocator.hpp>
+#include <vulkan_device.hpp>
+#include <vulkan_utility.hpp>
+
+#include <fmt/format.h>
+
+#include <cassert>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace
+{
+    constexpr VkDeviceSize texel_size{4};
+
+    [[nodiscard]] VkDeviceSize image_size(VkExtent2D const extent)
+    {
+        return VkDeviceSize{extent.width} * extent.height * texel_size;
+    }
+} // namespace
+
+vkpong::frame_readback::frame_readback(vulkan_device* const device)
+    : device_{device}
+    , timeline_{create_timeline_semaphore(device_->logical(), 0)}
+    , worker_{[this](std::stop_token const& token) { consume(token); }}
+{
+}
+
+vkpong::frame_readback::~frame_readback()
+{
+    worker_.request_stop();
+    worker_.join();
+
+    vkDestroySemaphore(device_->logical(), timeline_, allocation_callbacks());
+}
+
+void vkpong::frame_readback::request(readback_consumer consumer)
+{
+    requests_.push_back(std::move(consumer));
+}
+
+void vkpong::frame_readback::set_continuous(readback_consumer consumer)
+{
+    continuous_ = std::move(consumer);
+}
+
+void vkpong::frame_readback::drop_requests() noexcept
+{
+    requests_.clear();
+}
+
+void vkpong::frame_readback::record_copy(VkCommandBuffer const command_buffer,
+    VkImage const image,
+    VkExtent2D const extent,
+    VkFormat const format,
+    uint64_t const frame)
+{
+    assert(!recorded_slot_);
+
+    slot& current{slots_[next_slot_]};
+    if (current.busy.load(std::memory_order_acquire))
+    {
+        skipped_frames_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    assert(is_readback_format(format));
+
+    VkDeviceSize const size{image_size(extent)};
+    if (!current.buffer || current.buffer->size() != size)
+    {
+        current.buffer.reset();
+        current.buffer.emplace(device_,
+            size,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            readback_memory);
+    }
+
+    VkBufferImageCopy region{};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = {extent.width, extent.height, 1};
+    vkCmdCopyImageToBuffer(command_buffer,
+        image,
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        current.buffer->buffer(),
+        1,
+        &region);
+
+    VkBufferMemoryBarrier2 barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+    barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+    barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = current.buffer->buffer();
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+
+    VkDependencyInfo dependency{};
+    dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency.bufferMemoryBarrierCount = 1;
+    dependency.pBufferMemoryBarriers = &barrier;
+    vkCmdPipelineBarrier2(command_buffer, &dependency);
+
+    current.busy.store(true, std::memory_order_relaxed);
+    current.timeline_value = ++timeline_value_;
+    current.image = {.frame = frame, .extent = extent, .format = format};
+    current.consumers = std::move(requests_);
+    requests_.clear();
+    if (continuous_)
+    {
+        current.consumers.push_back(continuous_);
+    }
+
+    recorded_slot_ = next_slot_;
+    next_slot_ = (next_slot_ + 1) % slot_count;
+}
+
+std::optional<VkSemaphoreSubmitInfo>
+vkpong::frame_readback::pending_signal() const
+{
+    if (!recorded_slot_)
+    {
+        return std::nullopt;
+    }
+
+    VkSemaphoreSubmitInfo rv{};
+    rv.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    rv.semaphore = timeline_;
+    rv.value = slots_[*recorded_slot_].timeline_value;
+    rv.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    return rv;
+}
+
+void vkpong::frame_readback::submitted()
+{
+    if (!recorded_slot_)
+    {
+        return;
+    }
+
+    {
+        std::scoped_lock const lock{queue_mutex_};
+        queue_.push_back(*recorded_slot_);
+    }
+    queue_condition_.notify_one();
+
+    recorded_slot_.reset();
+}
+
+void vkpong::frame_readback::consume(std::stop_token const& token)
+{
+    constexpr auto timeout{std::numeric_limits<uint64_t>::max()};
+
+    while (true)
+    {
+        size_t index{};
+        {
+            std::unique_lock lock{queue_mutex_};
+            if (!queue_condition_.wait(lock,
+                    token,
+                    [this]() { return !queue_.empty(); }))
+            {
+                return;
+            }
+
+            index = queue_.front();
+            queue_.pop_front();
+        }
+
+        slot& current{slots_[index]};
+
+        VkSemaphoreWaitInfo wait_info{};
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &timeline_;
+        wait_info.pValues = &current.timeline_value;
+        if (vkWaitSemaphores(device_->logical(), &wait_info, timeout) ==
+            VK_SUCCESS)
+        {
+            current.buffer->invalidate(0, current.buffer->size());
+
+            readback_image image{current.image};
+            image.pixels = current.buffer->mapped_bytes();
+            for (readback_consumer const& consumer : current.consumers)
+            {
+                consumer(image);
+            }
+        }
+
+        current.consumers.clear();
+        current.busy.store(false, std::memory_order_release);
+    }
+}
+
+bool vkpong::has_bgra_layout(VkFormat const format)
+{
+    return format == VK_FORMAT_B8G8R8A8_SRGB ||
+        format == VK_FORMAT_B8G8R8A8_UNORM;
+}
+
+bool vkpong::is_readback_format(VkFormat const format)
+{
+    return has_bgra_layout(format) || format == VK_FORMAT_R8G8B8A8_SRGB ||
+        format == VK_FORMAT_R8G8B8A8_UNORM;
+}
+
+void vkpong::write_ppm(std::filesystem::path const& path,
+    readback_image const& image)
+{
+    std::ofstream stream{path, std::ios::binary};
+    if (!stream.is_open())
+    {
+        throw std::runtime_error{"failed to open file!"};
+    }
+
+    std::string const header{fmt::format("P6\n{} {}\n255\n",
+        image.extent.width,
+        image.extent.height)};
+    stream.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    bool const bgra{has_bgra_layout(image.format)};
+    std::string row(size_t{image.extent.width} * 3, '\0');
+    for (uint32_t y{}; y != image.extent.height; ++y)
+    {
+        auto const source{image.pixels.subspan(
+            size_t{y} * image.extent.width * texel_size,
+            size_t{image.extent.width} * texel_size)};
+        for (size_t x{}; x != image.extent.width; ++x)
+        {
+            auto const texel{source.subspan(x * texel_size, 3)};
+            row[x * 3] = static_cast<char>(texel[bgra ? 2 : 0]);
+            row[x * 3 + 1] = static_cast<char>(texel[1]);
+            row[x * 3 + 2] = static_cast<char>(texel[bgra ? 0 : 2]);
+        }
+        stream.write(row.data(), static_cast<std::streamsize>(row.size()));
+    }
+}
@@ -0,0 +1,140 @@
+#ifndef VKPONG_FRAME_READBACK_INCLUDED
+#define VKPONG_FRAME_READBACK_INCLUDED
+
+#include <vulkan_buffer.hpp>
+#include <vulkan_render_target.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace vkpong
+{
+    class vulkan_device;
+} // namespace vkpong
+
+namespace vkpong
+{
+    struct [[nodiscard]] readback_image final
+    {
+        uint64_t frame{};
+        VkExtent2D extent{};
+        VkFormat format{};
+        std::span<std::byte const> pixels;
+    };
+
+    // Invoked on the readback thread, pixels are valid only for the duration
+    // of the call.
+    using readback_consumer = std::function<void(readback_image const&)>;
+
+    class [[nodiscard]] frame_readback final
+    {
+    public: // Constants
+        static constexpr size_t slot_count{
+            vulkan_render_target::max_frames_in_flight + 1};
+
+    public: // Construction
+        explicit frame_readback(vulkan_device* device);
+
+        frame_readback(frame_readback const&) = delete;
+
+        frame_readback(frame_readback&&) noexcept = delete;
+
+    public: // Destruction
+        ~frame_readback();
+
+    public: // Interface
+        void request(readback_consumer consumer);
+
+        void set_continuous(readback_consumer consumer);
+
+        [[nodiscard]] bool wanted() const noexcept;
+
+        // Drops pending requests which can't be served, the continuous
+        // consumer stays set.
+        void drop_requests() noexcept;
+
+        void record_copy(VkCommandBuffer command_buffer,
+            VkImage image,
+            VkExtent2D extent,
+            VkFormat format,
+            uint64_t frame);
+
+        [[nodiscard]] std::optional<VkSemaphoreSubmitInfo>
+        pending_signal() const;
+
+        void submitted();
+
+        [[nodiscard]] uint64_t skipped_frames() const noexcept;
+
+    public: // Operators
+        frame_readback& operator=(frame_readback const&) = delete;
+
+        frame_readback& operator=(frame_readback&&) noexcept = delete;
+
+    private: // Types
+        struct [[nodiscard]] slot final
+        {
+            std::optional<vulkan_buffer> buffer;
+            std::atomic<bool> busy;
+            uint64_t timeline_value{};
+            readback_image image;
+            std::vector<readback_consumer> consumers;
+        };
+
+    private: // Helpers
+        void consume(std::stop_token const& token);
+
+    private: // Data
+        vulkan_device* device_;
+        VkSemaphore timeline_{};
+        uint64_t timeline_value_{};
+
+        std::array<slot, slot_count> slots_;
+        size_t next_slot_{};
+        std::optional<size_t> recorded_slot_;
+
+        std::vector<readback_consumer> requests_;
+        readback_consumer continuous_;
+        std::atomic<uint64_t> skipped_frames_{};
+
+        std::mutex queue_mutex_;
+        std::condition_variable_any queue_condition_;
+        std::deque<size_t> queue_;
+
+        std::jthread worker_;
+    };
+
+    [[nodiscard]] bool has_bgra_layout(VkFormat format);
+
+    // Readback consumers interpret pixels as 8 bit RGBA or BGRA texels.
+    [[nodiscard]] bool is_readback_format(VkFormat format);
+
+    void write_ppm(std::filesystem::path const& path,
+        readback_image const& image);
+} // namespace vkpong
+
+inline bool vkpong::frame_readback::wanted() const noexcept
+{
+    return !requests_.empty() || static_cast<bool>(continuous_);
+}
+
+inline uint64_t vkpong::frame_readback::skipped_frames() const noexcept
+{
+    return skipped_frames_.load(std::memory_order_relaxed);
+}
+
+#endif // !VKPONG_FRAME_READBACK_INCLUDED
@@ -9,6 +9,9 @@ namespace
 
 void vkpong::game::tick()
 {
+    events.clear();
+    ++tick_count;
+
     if (auto current_diff{std::abs(npc_position - ball_position.second)};
         current_diff > vertical_delta)
     {
@@ -27,30 +30,39 @@ void vkpong::game::tick()
     {
         if (std::abs(npc_position - ball_position.second) >= 0.2f)
         {
+            ++player_score;
+            events.push_back({game_event_type::goal, new_ball_position});
             ball_position = {0.f, 0.f};
             return;
         }
         else
         {
             ball_vector = {ball_vector.first * -1, ball_vector.second * -1};
+            events.push_back(
+                {game_event_type::paddle_bounce, new_ball_position});
         }
     }
     else if (new_ball_position.first >= 0.86f)
     {
         if (std::abs(player_position - ball_position.second) >= 0.2f)
         {
+            ++npc_score;
+            events.push_back({game_event_type::goal, new_ball_position});
             ball_position = {0.f, 0.f};
             return;
         }
         else
         {
             ball_vector = {ball_vector.first * -1, ball_vector.second * -1};
+            events.push_back(
+                {game_event_type::paddle_bounce, new_ball_position});
         }
     }
 
     if (new_ball_position.second <= -1.f || new_ball_position.second >= 1.f)
     {
         ball_vector.second *= -1;
+        events.push_back({game_event_type::wall_bounce, new_ball_position});
     }
     else
     {
@@ -1,7 +1,9 @@
 #ifndef VKPONG_GAME_INCLUDED
 #define VKPONG_GAME_INCLUDED
 
+#include <cstdint>
 #include <utility>
+#include <vector>
 
 namespace vkpong
 {
@@ -11,6 +13,19 @@ namespace vkpong
         down
     };
 
+    enum class game_event_type : uint8_t
+    {
+        paddle_bounce,
+        wall_bounce,
+        goal
+    };
+
+    struct [[nodiscard]] game_event final
+    {
+        game_event_type type;
+        std::pair<float, float> position;
+    };
+
     class [[nodiscard]] game final
     {
     public:
@@ -18,6 +33,12 @@ namespace vkpong
         float npc_position{};
         std::pair<float, float> ball_position{};
         std::pair<float, float> ball_vector{0.01f, 0.01f};
+        uint32_t player_score{};
+        uint32_t npc_score{};
+
+        // Events raised during the last tick.
+        std::vector<game_event> events;
+        uint64_t tick_count{};
 
         void tick();
 
@@ -0,0 +1,70 @@
+#ifndef VKPONG_GPU_LAYOUT_INCLUDED
+#define VKPONG_GPU_LAYOUT_INCLUDED
+
+#include <glm/glm.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace vkpong
+{
+    // Base alignment of a member type within std140 and std430 blocks,
+    // three component vectors are aligned like four component ones.
+    template<typename T>
+    inline constexpr size_t gpu_alignment{};
+
+    template<>
+    inline constexpr size_t gpu_alignment<float>{4};
+
+    template<>
+    inline constexpr size_t gpu_alignment<int32_t>{4};
+
+    template<>
+    inline constexpr size_t gpu_alignment<uint32_t>{4};
+
+    template<>
+    inline constexpr size_t gpu_alignment<glm::fvec2>{8};
+
+    template<>
+    inline constexpr size_t gpu_alignment<glm::fvec3>{16};
+
+    template<>
+    inline constexpr size_t gpu_alignment<glm::fvec4>{16};
+
+    template<>
+    inline constexpr size_t gpu_alignment<glm::mat4>{16};
+
+    // Structures which can be written directly into mapped memory.
+    template<typename T>
+    concept host_shareable = std::is_trivially_copyable_v<T> &&
+        std::is_standard_layout_v<T> && sizeof(T) % sizeof(uint32_t) == 0;
+
+    // Arrays of structures in std430 blocks are strided by the size of the
+    // structure rounded up to the alignment of its largest member.
+    template<typename T, size_t LargestAlignment>
+    concept std430_layout =
+        host_shareable<T> && sizeof(T) % LargestAlignment == 0;
+
+    // Structures and arrays in std140 blocks are rounded up to 16 bytes.
+    template<typename T>
+    concept std140_layout = host_shareable<T> && sizeof(T) % 16 == 0;
+
+    // Structures read by shaders as a flat array of 32 bit words.
+    template<typename T, size_t Words>
+    concept word_stream_layout =
+        host_shareable<T> && sizeof(T) == Words * sizeof(uint32_t);
+
+    // Member offsets can't be reflected, structures shared with shaders
+    // check each member whose alignment differs between C++ and GLSL.
+    template<typename Member>
+    [[nodiscard]] consteval bool gpu_aligned(size_t const offset)
+    {
+        static_assert(gpu_alignment<Member> != 0,
+            "type has no GLSL equivalent");
+        return offset % gpu_alignment<Member> == 0;
+    }
+} // namespace vkpong
+
+#endif // !VKPONG_GPU_LAYOUT_INCLUDED
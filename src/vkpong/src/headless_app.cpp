@@ -0,0 +1,125 @@
+#include <headless_app.hpp>
+
+#include <app_options.hpp>
+#include <diagnostics.hpp>
+#include <frame_capture.hpp>
+#include <frame_readback.hpp>
+#include <resolution_scaler.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+vkpong::headless_app::headless_app(uint32_t const width,
+    uint32_t const height,
+    bool const enable_validation_layers)
+    : context_{create_context(nullptr, enable_validation_layers)}
+    , device_{create_device(context_)}
+    , target_{&device_, VkExtent2D{width, height}}
+    , renderer_{nullptr, &context_, &device_, &target_}
+{
+}
+
+void vkpong::headless_app::run(app_options const& opts)
+{
+    using clock = std::chrono::steady_clock;
+    using milliseconds = std::chrono::duration<double, std::milli>;
+
+    frame_timings total;
+
+    renderer_.profiler().set_statistics_enabled(opts.statistics);
+    renderer_.set_overdraw_view(opts.overdraw);
+    if (opts.dynamic_resolution)
+    {
+        enable_dynamic_resolution(opts.frame_budget_us);
+    }
+
+    if (!opts.capture.empty())
+    {
+        renderer_.readback().set_continuous(
+            [capture_file = std::make_shared<frame_capture>(
+                 opts.capture,
+                 target_.extent(),
+                 frame_capture::default_frame_rate)](
+                readback_image const& image)
+            { capture_file->push(image); });
+    }
+
+    auto const start{clock::now()};
+    for (uint32_t i{}; i != opts.frames; ++i)
+    {
+        if (i + 1 == opts.frames && !opts.screenshot.empty())
+        {
+            renderer_.readback().request(
+                [&screenshot = opts.screenshot](readback_image const& image)
+                { save_screenshot(screenshot, image); });
+        }
+
+        draw_frame();
+
+        auto const& timings{renderer_.last_frame_timings()};
+        total.acquire += timings.acquire;
+        total.record += timings.record;
+        total.submit += timings.submit;
+    }
+    vkDeviceWaitIdle(device_.logical());
+    std::chrono::duration<double> const elapsed{clock::now() - start};
+    renderer_.readback().set_continuous({});
+
+    uint32_t const frames{opts.frames};
+    auto const average = [frames](std::chrono::nanoseconds const time)
+    { return milliseconds{time}.count() / frames; };
+
+    spdlog::info("Rendered {} frames at {}x{} in {:.3f} s, {:.1f} FPS",
+        frames,
+        target_.extent().width,
+        target_.extent().height,
+        elapsed.count(),
+        frames / elapsed.count());
+    spdlog::info("Average CPU time per frame: acquire {:.3f} ms, "
+                 "record {:.3f} ms, submit {:.3f} ms",
+        average(total.acquire),
+        average(total.record),
+        average(total.submit));
+    log_gpu_timings(renderer_.profiler());
+    log_statistics(renderer_.profiler(), target_.extent());
+    log_memory(device_);
+    if (renderer_.quality().dynamic_resolution)
+    {
+        resolution_scaler const& scaler{renderer_.scaler()};
+        spdlog::info("Dynamic resolution scale {:.2f}, "
+                     "GPU {:.3f} ms of {:.3f} ms budget",
+            scaler.scale(),
+            scaler.smoothed_time(),
+            scaler.budget());
+    }
+}
+
+void vkpong::headless_app::draw_frame()
+{
+    game_.tick();
+    renderer_.draw(game_);
+}
+
+void vkpong::headless_app::enable_dynamic_resolution(uint32_t const budget_us)
+{
+    if (!renderer_.dynamic_resolution_supported())
+    {
+        spdlog::warn("Dynamic resolution is not supported");
+        return;
+    }
+
+    if (budget_us != 0)
+    {
+        renderer_.scaler().set_budget(budget_us / 1000.0);
+    }
+
+    render_quality quality{renderer_.quality()};
+    quality.dynamic_resolution = true;
+    renderer_.set_quality(quality);
+
+    // Quality changes are applied at the end of a frame.
+    draw_frame();
+}
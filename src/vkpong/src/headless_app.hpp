@@ -0,0 +1,81 @@
+#ifndef VKPONG_HEADLESS_APP_INCLUDED
+#define VKPONG_HEADLESS_APP_INCLUDED
+
+#include <game.hpp>
+#include <vulkan_context.hpp>
+#include <vulkan_device.hpp>
+#include <vulkan_offscreen_target.hpp>
+#include <vulkan_renderer.hpp>
+
+#include <cstdint>
+
+namespace vkpong
+{
+    struct app_options;
+} // namespace vkpong
+
+namespace vkpong
+{
+    // Renders the game into an offscreen target without a window.
+    class [[nodiscard]] headless_app final
+    {
+    public: // Construction
+        headless_app(uint32_t width,
+            uint32_t height,
+            bool enable_validation_layers);
+
+        headless_app(headless_app const&) = delete;
+
+        headless_app(headless_app&&) noexcept = delete;
+
+    public: // Destruction
+        ~headless_app() = default;
+
+    public: // Interface
+        // Renders the requested number of frames and logs the timings.
+        void run(app_options const& opts);
+
+        // Advances the game by one tick and draws it.
+        void draw_frame();
+
+        [[nodiscard]] constexpr vulkan_device& device() noexcept;
+
+        [[nodiscard]] constexpr vulkan_offscreen_target& target() noexcept;
+
+        [[nodiscard]] constexpr vulkan_renderer& renderer() noexcept;
+
+    public: // Operators
+        headless_app& operator=(headless_app const&) = delete;
+
+        headless_app& operator=(headless_app&&) noexcept = delete;
+
+    private: // Helpers
+        void enable_dynamic_resolution(uint32_t budget_us);
+
+    private: // Data
+        game game_;
+        vulkan_context context_;
+        vulkan_device device_;
+        vulkan_offscreen_target target_;
+        vulkan_renderer renderer_;
+    };
+} // namespace vkpong
+
+inline constexpr vkpong::vulkan_device& vkpong::headless_app::device() noexcept
+{
+    return device_;
+}
+
+inline constexpr vkpong::vulkan_offscreen_target&
+vkpong::headless_app::target() noexcept
+{
+    return target_;
+}
+
+inline constexpr vkpong::vulkan_renderer&
+vkpong::headless_app::renderer() noexcept
+{
+    return renderer_;
+}
+
+#endif // !VKPONG_HEADLESS_APP_INCLUDED
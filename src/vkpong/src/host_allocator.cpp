@@ -0,0 +1,229 @@
+#include <host_allocator.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace
+{
+    struct [[nodiscard]] command_arena final
+    {
+        std::unique_ptr<std::byte[]> storage{std::make_unique<std::byte[]>(
+            vkpong::host_allocator::arena_size)};
+        // Only touched by the thread owning the arena.
+        size_t head{};
+        // Allocations may be freed on any thread.
+        std::atomic<size_t> live{};
+    };
+
+    // Stored right before the pointer handed to the driver.
+    struct [[nodiscard]] allocation_header final
+    {
+        size_t size{};
+        // From the start of the underlying allocation.
+        size_t offset{};
+        size_t alignment{};
+        command_arena* arena{};
+        VkSystemAllocationScope scope{};
+    };
+
+    [[nodiscard]] command_arena& thread_arena()
+    {
+        thread_local command_arena rv;
+        return rv;
+    }
+
+    [[nodiscard]] allocation_header& header_of(void* const memory)
+    {
+        // NOLINTNEXTLINE
+        return *reinterpret_cast<allocation_header*>(
+            static_cast<std::byte*>(memory) - sizeof(allocation_header));
+    }
+
+    [[nodiscard]] size_t align_up(size_t const value, size_t const alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    [[nodiscard]] std::byte* allocate_from_arena(command_arena& arena,
+        size_t const size,
+        size_t const alignment)
+    {
+        // The last free may have happened on another thread, the arena is
+        // rewound here on its own thread instead.
+        if (arena.live.load(std::memory_order_acquire) == 0)
+        {
+            arena.head = 0;
+        }
+
+        // NOLINTNEXTLINE
+        auto const base{reinterpret_cast<uintptr_t>(arena.storage.get())};
+        size_t const offset{
+            align_up(base + arena.head + sizeof(allocation_header),
+                alignment) -
+            base};
+        if (offset + size > vkpong::host_allocator::arena_size)
+        {
+            return nullptr;
+        }
+
+        arena.head = offset + size;
+        arena.live.fetch_add(1, std::memory_order_relaxed);
+        return arena.storage.get() + offset;
+    }
+} // namespace
+
+vkpong::host_allocator::host_allocator()
+{
+    callbacks_.pUserData = this;
+    callbacks_.pfnAllocation = allocate;
+    callbacks_.pfnReallocation = reallocate;
+    callbacks_.pfnFree = deallocate;
+}
+
+void vkpong::host_allocator::end_frame()
+{
+    for (size_t i{}; i != counters_.size(); ++i)
+    {
+        scope_counters& counters{counters_[i]};
+        host_scope_statistics& scope{statistics_.scopes[i]};
+        scope.frame_allocations = counters.frame_allocations.exchange(0);
+        scope.frame_frees = counters.frame_frees.exchange(0);
+        scope.frame_allocated_bytes =
+            counters.frame_allocated_bytes.exchange(0);
+        scope.live_allocations = counters.live_allocations.load();
+        scope.live_bytes = counters.live_bytes.load();
+    }
+    statistics_.frame_arena_allocations =
+        frame_arena_allocations_.exchange(0);
+}
+
+void* vkpong::host_allocator::allocate(void* const user_data,
+    size_t const size,
+    size_t const alignment,
+    VkSystemAllocationScope const scope)
+{
+    if (size == 0)
+    {
+        return nullptr;
+    }
+
+    auto* const self{static_cast<host_allocator*>(user_data)};
+    size_t const actual_alignment{
+        std::max(alignment, alignof(allocation_header))};
+
+    std::byte* rv{};
+    command_arena* arena{};
+    size_t offset{};
+    if (scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND)
+    {
+        arena = &thread_arena();
+        rv = allocate_from_arena(*arena, size, actual_alignment);
+        if (rv)
+        {
+            self->frame_arena_allocations_.fetch_add(1,
+                std::memory_order_relaxed);
+        }
+        else
+        {
+            arena = nullptr;
+        }
+    }
+
+    if (!rv)
+    {
+        offset = align_up(sizeof(allocation_header), actual_alignment);
+        void* const base{::operator new(offset + size,
+            std::align_val_t{actual_alignment},
+            std::nothrow)};
+        if (!base)
+        {
+            return nullptr;
+        }
+        rv = static_cast<std::byte*>(base) + offset;
+    }
+
+    header_of(rv) = {.size = size,
+        .offset = offset,
+        .alignment = actual_alignment,
+        .arena = arena,
+        .scope = scope};
+
+    scope_counters& counters{self->counters_[static_cast<size_t>(scope)]};
+    counters.frame_allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.frame_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    counters.live_allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.live_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    return rv;
+}
+
+void* vkpong::host_allocator::reallocate(void* const user_data,
+    void* const original,
+    size_t const size,
+    size_t const alignment,
+    VkSystemAllocationScope const scope)
+{
+    if (!original)
+    {
+        return allocate(user_data, size, alignment, scope);
+    }
+
+    if (size == 0)
+    {
+        deallocate(user_data, original);
+        return nullptr;
+    }
+
+    // Original memory must stay valid when the reallocation fails.
+    void* const rv{allocate(user_data, size, alignment, scope)};
+    if (rv)
+    {
+        std::memcpy(rv, original, std::min(size, header_of(original).size));
+        deallocate(user_data, original);
+    }
+
+    return rv;
+}
+
+void vkpong::host_allocator::deallocate(void* const user_data,
+    void* const memory)
+{
+    if (!memory)
+    {
+        return;
+    }
+
+    auto* const self{static_cast<host_allocator*>(user_data)};
+    allocation_header const header{header_of(memory)};
+
+    scope_counters& counters{
+        self->counters_[static_cast<size_t>(header.scope)]};
+    counters.frame_frees.fetch_add(1, std::memory_order_relaxed);
+    counters.live_allocations.fetch_sub(1, std::memory_order_relaxed);
+    counters.live_bytes.fetch_sub(header.size, std::memory_order_relaxed);
+
+    if (header.arena)
+    {
+        // Releases the memory for reuse by the owning thread.
+        header.arena->live.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+
+    ::operator delete(static_cast<std::byte*>(memory) - header.offset,
+        std::align_val_t{header.alignment});
+}
+
+vkpong::host_allocator& vkpong::default_host_allocator()
+{
+    static host_allocator rv;
+    return rv;
+}
+
+VkAllocationCallbacks const* vkpong::allocation_callbacks()
+{
+    return default_host_allocator().callbacks();
+}
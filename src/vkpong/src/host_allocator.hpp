@@ -0,0 +1,118 @@
+#ifndef VKPONG_HOST_ALLOCATOR_INCLUDED
+#define VKPONG_HOST_ALLOCATOR_INCLUDED
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace vkpong
+{
+    // One per VkSystemAllocationScope.
+    inline constexpr size_t host_scope_count{5};
+
+    struct [[nodiscard]] host_scope_statistics final
+    {
+        uint64_t frame_allocations{};
+        uint64_t frame_frees{};
+        uint64_t frame_allocated_bytes{};
+        uint64_t live_allocations{};
+        uint64_t live_bytes{};
+    };
+
+    struct [[nodiscard]] host_allocation_statistics final
+    {
+        std::array<host_scope_statistics, host_scope_count> scopes{};
+        // Command scope allocations served by the thread local arena.
+        uint64_t frame_arena_allocations{};
+    };
+
+    // Host memory allocator for the driver, accounting allocations by their
+    // allocation scope. Command scope allocations only live for the duration
+    // of a call and are bumped from a thread local arena. The arena is
+    // rewound by its thread once all of its allocations are freed, they may
+    // be freed on any thread.
+    class [[nodiscard]] host_allocator final
+    {
+    public: // Constants
+        static constexpr size_t arena_size{size_t{64} << 10};
+
+    public: // Construction
+        host_allocator();
+
+        host_allocator(host_allocator const&) = delete;
+
+        host_allocator(host_allocator&&) noexcept = delete;
+
+    public: // Destruction
+        ~host_allocator() = default;
+
+    public: // Interface
+        [[nodiscard]] constexpr VkAllocationCallbacks const*
+        callbacks() const noexcept;
+
+        // Closes the per frame counters, statistics report the last closed
+        // frame.
+        void end_frame();
+
+        [[nodiscard]] constexpr host_allocation_statistics const&
+        statistics() const noexcept;
+
+    public: // Operators
+        host_allocator& operator=(host_allocator const&) = delete;
+
+        host_allocator& operator=(host_allocator&&) noexcept = delete;
+
+    private: // Types
+        struct [[nodiscard]] scope_counters final
+        {
+            std::atomic<uint64_t> frame_allocations;
+            std::atomic<uint64_t> frame_frees;
+            std::atomic<uint64_t> frame_allocated_bytes;
+            std::atomic<uint64_t> live_allocations;
+            std::atomic<uint64_t> live_bytes;
+        };
+
+    private: // Helpers
+        static void* VKAPI_PTR allocate(void* user_data,
+            size_t size,
+            size_t alignment,
+            VkSystemAllocationScope scope);
+
+        static void* VKAPI_PTR reallocate(void* user_data,
+            void* original,
+            size_t size,
+            size_t alignment,
+            VkSystemAllocationScope scope);
+
+        static void VKAPI_PTR deallocate(void* user_data, void* memory);
+
+    private: // Data
+        VkAllocationCallbacks callbacks_{};
+        std::array<scope_counters, host_scope_count> counters_{};
+        std::atomic<uint64_t> frame_arena_allocations_{};
+        host_allocation_statistics statistics_;
+    };
+
+    [[nodiscard]] host_allocator& default_host_allocator();
+
+    // Passed to every Vulkan call taking allocation callbacks, objects must
+    // be destroyed with the callbacks they were created with.
+    [[nodiscard]] VkAllocationCallbacks const* allocation_callbacks();
+} // namespace vkpong
+
+inline constexpr VkAllocationCallbacks const*
+vkpong::host_allocator::callbacks() const noexcept
+{
+    return &callbacks_;
+}
+
+inline constexpr vkpong::host_allocation_statistics const&
+vkpong::host_allocator::statistics() const noexcept
+{
+    return statistics_;
+}
+
+#endif // !VKPONG_HOST_ALLOCATOR_INCLUDED
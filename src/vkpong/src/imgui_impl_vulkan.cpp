@@ -1968,7 +1968,8 @@ void ImGui_ImplVulkan_NewFrame()
     ImGui_ImplVulkan_Data* bd = ImGui_ImplVulkan_GetBackendData();
     IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplVulkan_Init()?");
 
-    if (!bd->FontDescriptorSet)
+    // vkpong: the font texture may be provided by the application
+    if (!bd->FontDescriptorSet && !ImGui::GetIO().Fonts->TexID)
         ImGui_ImplVulkan_CreateFontsTexture();
 }
 
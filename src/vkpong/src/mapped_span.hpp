@@ -0,0 +1,132 @@
+#ifndef VKPONG_MAPPED_SPAN_INCLUDED
+#define VKPONG_MAPPED_SPAN_INCLUDED
+
+#include <gpu_layout.hpp>
+#include <ring_allocator.hpp>
+#include <vulkan_buffer.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace vkpong
+{
+    // Constructs elements in place in a persistently mapped range. Mapped
+    // memory is usually write combined, elements are only appended and
+    // never read back. Written elements of a buffer range are marked as
+    // written when the span is destroyed, ring ranges are flushed by the
+    // ring itself.
+    template<host_shareable T>
+    class [[nodiscard]] mapped_span final
+    {
+    public: // Construction
+        mapped_span(vulkan_buffer& buffer,
+            VkDeviceSize offset,
+            size_t capacity);
+
+        explicit mapped_span(ring_allocation const& range);
+
+        mapped_span(mapped_span const&) = delete;
+
+        mapped_span(mapped_span&&) noexcept = delete;
+
+    public: // Destruction
+        ~mapped_span();
+
+    public: // Interface
+        template<typename... Args>
+        T& emplace_back(Args&&... args);
+
+        [[nodiscard]] constexpr size_t size() const noexcept;
+
+        [[nodiscard]] constexpr size_t capacity() const noexcept;
+
+        [[nodiscard]] constexpr bool full() const noexcept;
+
+    public: // Operators
+        mapped_span& operator=(mapped_span const&) = delete;
+
+        mapped_span& operator=(mapped_span&&) noexcept = delete;
+
+    private: // Helpers
+        [[nodiscard]] static T* elements(std::byte* data);
+
+    private: // Data
+        vulkan_buffer* buffer_{};
+        T* data_{};
+        VkDeviceSize offset_{};
+        size_t capacity_{};
+        size_t size_{};
+    };
+} // namespace vkpong
+
+template<vkpong::host_shareable T>
+vkpong::mapped_span<T>::mapped_span(vulkan_buffer& buffer,
+    VkDeviceSize const offset,
+    size_t const capacity)
+    : buffer_{&buffer}
+    , data_{elements(buffer.mapped_bytes().subspan(offset).data())}
+    , offset_{offset}
+    , capacity_{capacity}
+{
+    assert(offset + capacity * sizeof(T) <= buffer.size());
+}
+
+template<vkpong::host_shareable T>
+vkpong::mapped_span<T>::mapped_span(ring_allocation const& range)
+    : data_{elements(range.data)}
+    , capacity_{range.size / sizeof(T)}
+{
+}
+
+template<vkpong::host_shareable T>
+vkpong::mapped_span<T>::~mapped_span()
+{
+    if (buffer_ && size_ != 0)
+    {
+        buffer_->mark_written(offset_, size_ * sizeof(T));
+    }
+}
+
+template<vkpong::host_shareable T>
+template<typename... Args>
+T& vkpong::mapped_span<T>::emplace_back(Args&&... args)
+{
+    assert(size_ != capacity_);
+
+    return *std::construct_at(data_ + size_++, std::forward<Args>(args)...);
+}
+
+template<vkpong::host_shareable T>
+inline constexpr size_t vkpong::mapped_span<T>::size() const noexcept
+{
+    return size_;
+}
+
+template<vkpong::host_shareable T>
+inline constexpr size_t vkpong::mapped_span<T>::capacity() const noexcept
+{
+    return capacity_;
+}
+
+template<vkpong::host_shareable T>
+inline constexpr bool vkpong::mapped_span<T>::full() const noexcept
+{
+    return size_ == capacity_;
+}
+
+template<vkpong::host_shareable T>
+T* vkpong::mapped_span<T>::elements(std::byte* const data)
+{
+    // NOLINTNEXTLINE
+    assert(reinterpret_cast<uintptr_t>(data) % alignof(T) == 0);
+
+    // NOLINTNEXTLINE
+    return reinterpret_cast<T*>(data);
+}
+
+#endif // !VKPONG_MAPPED_SPAN_INCLUDED
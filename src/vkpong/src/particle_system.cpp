@@ -0,0 +1,641 @@
+#include <particle_system.hpp>
+
+#include <host_allocator.hpp>
+#include <mapped_span.hpp>
+#include <vulkan_device.hpp>
+#include <vulkan_pipeline.hpp>
+#include <vulkan_utility.hpp>
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    constexpr uint32_t emit_group_size{64};
+    constexpr uint32_t simulate_group_size{256};
+    constexpr uint32_t quad_vertex_count{6};
+
+    constexpr float drag{2.0f};
+    constexpr float particle_size{0.008f};
+
+    struct [[nodiscard]] emit_constants final
+    {
+        uint32_t cursor;
+        uint32_t capacity;
+        uint32_t emitter_count;
+        uint32_t particle_count;
+        uint32_t seed;
+    };
+
+    struct [[nodiscard]] simulate_constants final
+    {
+        float delta_time;
+        float drag;
+        uint32_t capacity;
+    };
+
+    struct [[nodiscard]] render_constants final
+    {
+        glm::fvec2 scale;
+    };
+
+    // Same integer hash as the emit shader, random numbers match bit for
+    // bit between the CPU and the GPU.
+    [[nodiscard]] constexpr uint32_t hash(uint32_t x)
+    {
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    [[nodiscard]] float random(uint32_t& state)
+    {
+        state = hash(state);
+        return static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // Assigns each burst its range within the update, limited to the
+    // number of emitters and the particle capacity. Returns the number of
+    // emitted particles.
+    template<typename Emitters>
+    [[nodiscard]] uint32_t prepare_emitters(
+        std::span<vkpong::particle_burst const> const bursts,
+        uint32_t const capacity,
+        Emitters& emitters)
+    {
+        uint32_t first{};
+        for (vkpong::particle_burst const& burst : bursts)
+        {
+            if (emitters.size() == vkpong::particle_system::max_emitters)
+            {
+                break;
+            }
+
+            uint32_t const count{std::min(burst.count, capacity - first)};
+            if (count == 0)
+            {
+                continue;
+            }
+
+            emitters.emplace_back(vkpong::particle_emitter{
+                .position = burst.position,
+                .direction = burst.direction,
+                .speed = burst.speed,
+                .spread = burst.spread,
+                .lifetime = burst.lifetime,
+                .color = glm::packUnorm4x8(glm::fvec4{burst.color, 1.0f}),
+                .count = count,
+                .first = first});
+            first += count;
+        }
+
+        return first;
+    }
+
+    [[nodiscard]] vkpong::particle emit_particle(
+        vkpong::particle_emitter const& emitter,
+        uint32_t const index,
+        uint32_t const seed)
+    {
+        uint32_t state{seed ^ hash(index)};
+        float const angle{std::atan2(emitter.direction.y, emitter.direction.x) +
+            (random(state) - 0.5f) * emitter.spread};
+        float const speed{emitter.speed * (0.25f + 0.75f * random(state))};
+        float const lifetime{emitter.lifetime * (0.5f + 0.5f * random(state))};
+
+        return {.position = emitter.position,
+            .velocity = {std::cos(angle) * speed, std::sin(angle) * speed},
+            .age = 0.0f,
+            .lifetime = lifetime,
+            .color = emitter.color,
+            .padding = 0};
+    }
+
+    [[nodiscard]] uint32_t group_count(uint32_t const count,
+        uint32_t const group_size)
+    {
+        return (count + group_size - 1) / group_size;
+    }
+
+    void memory_barrier(VkCommandBuffer const command_buffer,
+        VkPipelineStageFlags2 const src_stage,
+        VkAccessFlags2 const src_access,
+        VkPipelineStageFlags2 const dst_stage,
+        VkAccessFlags2 const dst_access)
+    {
+        VkMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = src_stage;
+        barrier.srcAccessMask = src_access;
+        barrier.dstStageMask = dst_stage;
+        barrier.dstAccessMask = dst_access;
+
+        VkDependencyInfo dependency{};
+        dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency.memoryBarrierCount = 1;
+        dependency.pMemoryBarriers = &barrier;
+
+        vkCmdPipelineBarrier2(command_buffer, &dependency);
+    }
+} // namespace
+
+bool vkpong::particles_match(particle const& lhs, particle const& rhs)
+{
+    // Transcendental functions are not exact in shaders, directions may
+    // differ slightly between the CPU and the GPU.
+    constexpr float tolerance{1e-2f};
+    auto const close = [](glm::fvec2 const a, glm::fvec2 const b)
+    {
+        return std::abs(a.x - b.x) <= tolerance &&
+            std::abs(a.y - b.y) <= tolerance;
+    };
+
+    bool const lhs_alive{lhs.age < lhs.lifetime};
+    bool const rhs_alive{rhs.age < rhs.lifetime};
+    if (!lhs_alive && !rhs_alive)
+    {
+        return true;
+    }
+
+    return lhs_alive == rhs_alive && lhs.color == rhs.color &&
+        std::abs(lhs.age - rhs.age) <= 1e-4f &&
+        std::abs(lhs.lifetime - rhs.lifetime) <= 1e-4f &&
+        close(lhs.position, rhs.position) && close(lhs.velocity, rhs.velocity);
+}
+
+vkpong::cpu_particle_system::cpu_particle_system(uint32_t const capacity)
+    : particles_(capacity)
+{
+}
+
+void vkpong::cpu_particle_system::emit(particle_burst const& burst)
+{
+    pending_.push_back(burst);
+}
+
+void vkpong::cpu_particle_system::update(float const delta_time)
+{
+    auto const capacity{count_cast(particles_.size())};
+
+    std::vector<particle_emitter> emitters;
+    emitters.reserve(std::min(pending_.size(), particle_system::max_emitters));
+    uint32_t const emitted{prepare_emitters(pending_, capacity, emitters)};
+    pending_.clear();
+
+    for (particle_emitter const& emitter : emitters)
+    {
+        for (uint32_t i{}; i != emitter.count; ++i)
+        {
+            uint32_t const index{emitter.first + i};
+            particles_[(cursor_ + index) % capacity] =
+                emit_particle(emitter, index, hash(seed_));
+        }
+    }
+    cursor_ = (cursor_ + emitted) % capacity;
+    ++seed_;
+
+    alive_count_ = 0;
+    for (particle& value : particles_)
+    {
+        if (value.age >= value.lifetime)
+        {
+            continue;
+        }
+
+        value.age += delta_time;
+        value.velocity *= std::max(1.0f - drag * delta_time, 0.0f);
+        value.position += value.velocity * delta_time;
+        if (value.age < value.lifetime)
+        {
+            ++alive_count_;
+        }
+    }
+}
+
+vkpong::particle_system::particle_system(vulkan_device* const device,
+    VkQueue const queue,
+    uint32_t const capacity)
+    : device_{device}
+    , capacity_{capacity}
+    , particles_{device,
+          VkDeviceSize{capacity} * sizeof(particle),
+          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+              VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+              VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+          device_local_memory}
+    , alive_indices_{device,
+          VkDeviceSize{capacity} * sizeof(uint32_t),
+          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+          device_local_memory}
+    , draw_command_{device,
+          sizeof(VkDrawIndirectCommand),
+          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+              VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+              VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+              VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+          device_local_memory}
+{
+    for (std::optional<vulkan_buffer>& emitters : emitters_)
+    {
+        emitters.emplace(device_,
+            max_emitters * sizeof(particle_emitter),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            dynamic_memory);
+    }
+
+    create_descriptors();
+
+    std::array const layouts{descriptor_set_layout_};
+    emit_pipeline_ =
+        std::make_unique<vulkan_pipeline>(create_compute_pipeline(device_,
+            "particle_emit.spv",
+            layouts,
+            VkPushConstantRange{.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                .offset = 0,
+                .size = sizeof(emit_constants)}));
+    simulate_pipeline_ =
+        std::make_unique<vulkan_pipeline>(create_compute_pipeline(device_,
+            "particle_simulate.spv",
+            layouts,
+            VkPushConstantRange{.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                .offset = 0,
+                .size = sizeof(simulate_constants)}));
+
+    // Zero lifetime marks every particle as dead.
+    submit_one_time(device_->logical(),
+        device_->graphics_family(),
+        queue,
+        [this](VkCommandBuffer const command_buffer)
+        {
+            vkCmdFillBuffer(command_buffer,
+                particles_.buffer(),
+                0,
+                VK_WHOLE_SIZE,
+                0);
+            vkCmdFillBuffer(command_buffer,
+                draw_command_.buffer(),
+                0,
+                VK_WHOLE_SIZE,
+                0);
+        });
+}
+
+vkpong::particle_system::~particle_system()
+{
+    render_pipeline_.reset();
+    simulate_pipeline_.reset();
+    emit_pipeline_.reset();
+
+    vkDestroyDescriptorPool(device_->logical(),
+        descriptor_pool_,
+        allocation_callbacks());
+    vkDestroyDescriptorSetLayout(device_->logical(),
+        descriptor_set_layout_,
+        allocation_callbacks());
+}
+
+void vkpong::particle_system::emit(particle_burst const& burst)
+{
+    pending_.push_back(burst);
+}
+
+void vkpong::particle_system::record_update(
+    VkCommandBuffer const command_buffer,
+    uint32_t const frame,
+    float const delta_time)
+{
+    uint32_t emitted{};
+    uint32_t emitter_count{};
+    {
+        mapped_span<particle_emitter> emitters{*emitters_[frame],
+            0,
+            max_emitters};
+        emitted = prepare_emitters(pending_, capacity_, emitters);
+        emitter_count = count_cast(emitters.size());
+    }
+    pending_.clear();
+
+    // Previous updates and draws reading the particles and the alive list
+    // have to finish before they are overwritten.
+    memory_barrier(command_buffer,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT |
+            VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT |
+            VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_COPY_BIT,
+        VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
+            VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT |
+            VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
+    VkDrawIndirectCommand const draw_command{.vertexCount = quad_vertex_count,
+        .instanceCount = 0,
+        .firstVertex = 0,
+        .firstInstance = 0};
+    vkCmdUpdateBuffer(command_buffer,
+        draw_command_.buffer(),
+        0,
+        sizeof(draw_command),
+        &draw_command);
+
+    memory_barrier(command_buffer,
+        VK_PIPELINE_STAGE_2_COPY_BIT,
+        VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
+            VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+    vkCmdBindDescriptorSets(command_buffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        emit_pipeline_->pipeline_layout(),
+        0,
+        1,
+        &descriptor_sets_[frame],
+        0,
+        nullptr);
+
+    if (emitted != 0)
+    {
+        emit_constants const constants{.cursor = cursor_,
+            .capacity = capacity_,
+            .emitter_count = emitter_count,
+            .particle_count = emitted,
+            .seed = hash(seed_)};
+
+        vkCmdBindPipeline(command_buffer,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            emit_pipeline_->pipeline());
+        vkCmdPushConstants(command_buffer,
+            emit_pipeline_->pipeline_layout(),
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            0,
+            sizeof(constants),
+            &constants);
+        vkCmdDispatch(command_buffer,
+            group_count(emitted, emit_group_size),
+            1,
+            1);
+
+        memory_barrier(command_buffer,
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
+                VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+        cursor_ = (cursor_ + emitted) % capacity_;
+    }
+    ++seed_;
+
+    simulate_constants const constants{.delta_time = delta_time,
+        .drag = drag,
+        .capacity = capacity_};
+
+    vkCmdBindPipeline(command_buffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        simulate_pipeline_->pipeline());
+    vkCmdPushConstants(command_buffer,
+        simulate_pipeline_->pipeline_layout(),
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(constants),
+        &constants);
+    vkCmdDispatch(command_buffer,
+        group_count(capacity_, simulate_group_size),
+        1,
+        1);
+
+    memory_barrier(command_buffer,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT |
+            VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT |
+            VK_PIPELINE_STAGE_2_COPY_BIT,
+        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT |
+            VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
+            VK_ACCESS_2_TRANSFER_READ_BIT);
+}
+
+void vkpong::particle_system::create_pipeline(VkFormat const image_format,
+    VkSampleCountFlagBits const samples,
+    bool const shader_objects)
+{
+    vulkan_pipeline_builder builder{device_, image_format};
+    if (shader_objects)
+    {
+        builder.with_shader_objects();
+    }
+    render_pipeline_ = std::make_unique<vulkan_pipeline>(
+        builder
+            .add_shader(VK_SHADER_STAGE_VERTEX_BIT, "particle_vert.spv", "main")
+            .add_shader(VK_SHADER_STAGE_FRAGMENT_BIT,
+                "particle_frag.spv",
+                "main")
+            .add_descriptor_set_layout(descriptor_set_layout_)
+            .with_rasterization_samples(samples)
+            .with_push_constants(
+                VkPushConstantRange{.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+                    .offset = 0,
+                    .size = sizeof(render_constants)})
+            .with_color_blending(VkPipelineColorBlendAttachmentState{
+                .blendEnable = VK_TRUE,
+                .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
+                .dstColorBlendFactor = VK_BLEND_FACTOR_ONE,
+                .colorBlendOp = VK_BLEND_OP_ADD,
+                .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+                .dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+                .alphaBlendOp = VK_BLEND_OP_ADD,
+                .colorWriteMask = VK_COLOR_COMPONENT_R_BIT |
+                    VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT |
+                    VK_COLOR_COMPONENT_A_BIT})
+            .build());
+}
+
+void vkpong::particle_system::draw(VkCommandBuffer const command_buffer,
+    uint32_t const frame,
+    VkExtent2D const extent) const
+{
+    render_pipeline_->bind(command_buffer);
+    vkCmdBindDescriptorSets(command_buffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        render_pipeline_->pipeline_layout(),
+        0,
+        1,
+        &descriptor_sets_[frame],
+        0,
+        nullptr);
+
+    render_constants const constants{
+        .scale = {particle_size * static_cast<float>(extent.height) /
+                static_cast<float>(extent.width),
+            particle_size}};
+    vkCmdPushConstants(command_buffer,
+        render_pipeline_->pipeline_layout(),
+        VK_SHADER_STAGE_VERTEX_BIT,
+        0,
+        sizeof(constants),
+        &constants);
+
+    vkCmdDrawIndirect(command_buffer,
+        draw_command_.buffer(),
+        0,
+        1,
+        sizeof(VkDrawIndirectCommand));
+}
+
+vkpong::particle_snapshot vkpong::particle_system::read_back(
+    VkQueue const queue) const
+{
+    VkDeviceSize const particles_size{VkDeviceSize{capacity_} *
+        sizeof(particle)};
+
+    vulkan_buffer staging{device_,
+        particles_size + sizeof(VkDrawIndirectCommand),
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        readback_memory};
+
+    submit_one_time(device_->logical(),
+        device_->graphics_family(),
+        queue,
+        [&](VkCommandBuffer const command_buffer)
+        {
+            VkBufferCopy const particles_region{.srcOffset = 0,
+                .dstOffset = 0,
+                .size = particles_size};
+            vkCmdCopyBuffer(command_buffer,
+                particles_.buffer(),
+                staging.buffer(),
+                1,
+                &particles_region);
+
+            VkBufferCopy const command_region{.srcOffset = 0,
+                .dstOffset = particles_size,
+                .size = sizeof(VkDrawIndirectCommand)};
+            vkCmdCopyBuffer(command_buffer,
+                draw_command_.buffer(),
+                staging.buffer(),
+                1,
+                &command_region);
+
+            memory_barrier(command_buffer,
+                VK_PIPELINE_STAGE_2_COPY_BIT,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_2_HOST_BIT,
+                VK_ACCESS_2_HOST_READ_BIT);
+        });
+
+    staging.invalidate(0, staging.size());
+    std::span<std::byte const> const bytes{staging.mapped_bytes()};
+
+    particle_snapshot rv{.particles = std::vector<particle>(capacity_)};
+    std::memcpy(rv.particles.data(), bytes.data(), particles_size);
+
+    VkDrawIndirectCommand draw_command;
+    std::memcpy(&draw_command,
+        bytes.data() + particles_size,
+        sizeof(draw_command));
+    rv.alive_count = draw_command.instanceCount;
+
+    return rv;
+}
+
+void vkpong::particle_system::create_descriptors()
+{
+    constexpr VkShaderStageFlags compute_and_vertex{
+        VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT};
+
+    std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+    for (uint32_t i{}; i != bindings.size(); ++i)
+    {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = i < 2
+            ? compute_and_vertex
+            : VkShaderStageFlags{VK_SHADER_STAGE_COMPUTE_BIT};
+    }
+
+    VkDescriptorSetLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.bindingCount = count_cast(bindings.size());
+    layout_info.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(device_->logical(),
+            &layout_info,
+            allocation_callbacks(),
+            &descriptor_set_layout_) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to create descriptor set layout!"};
+    }
+
+    constexpr auto count{
+        count_cast(vulkan_render_target::max_frames_in_flight)};
+    VkDescriptorPoolSize const pool_size{
+        .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .descriptorCount = count * count_cast(bindings.size())};
+
+    VkDescriptorPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.poolSizeCount = 1;
+    pool_info.pPoolSizes = &pool_size;
+    pool_info.maxSets = count;
+    if (vkCreateDescriptorPool(device_->logical(),
+            &pool_info,
+            allocation_callbacks(),
+            &descriptor_pool_) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to create descriptor pool!"};
+    }
+
+    std::array<VkDescriptorSetLayout,
+        vulkan_render_target::max_frames_in_flight>
+        layouts{};
+    layouts.fill(descriptor_set_layout_);
+
+    VkDescriptorSetAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.descriptorPool = descriptor_pool_;
+    alloc_info.descriptorSetCount = count;
+    alloc_info.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(device_->logical(),
+            &alloc_info,
+            descriptor_sets_.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to allocate descriptor sets!"};
+    }
+
+    for (size_t frame{}; frame != descriptor_sets_.size(); ++frame)
+    {
+        std::array const buffers{particles_.buffer(),
+            alive_indices_.buffer(),
+            draw_command_.buffer(),
+            emitters_[frame]->buffer()};
+
+        std::array<VkDescriptorBufferInfo, bindings.size()> buffer_infos{};
+        std::array<VkWriteDescriptorSet, bindings.size()> writes{};
+        for (uint32_t i{}; i != writes.size(); ++i)
+        {
+            buffer_infos[i].buffer = buffers[i];
+            buffer_infos[i].offset = 0;
+            buffer_infos[i].range = VK_WHOLE_SIZE;
+
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = descriptor_sets_[frame];
+            writes[i].dstBinding = i;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].descriptorCount = 1;
+            writes[i].pBufferInfo = &buffer_infos[i];
+        }
+
+        vkUpdateDescriptorSets(device_->logical(),
+            count_cast(writes.size()),
+            writes.data(),
+            0,
+            nullptr);
+    }
+}
@@ -0,0 +1,220 @@
+#ifndef VKPONG_PARTICLE_SYSTEM_INCLUDED
+#define VKPONG_PARTICLE_SYSTEM_INCLUDED
+
+#include <gpu_layout.hpp>
+#include <vulkan_buffer.hpp>
+#include <vulkan_render_target.hpp>
+
+#include <glm/glm.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace vkpong
+{
+    class vulkan_device;
+    class vulkan_pipeline;
+} // namespace vkpong
+
+namespace vkpong
+{
+    struct [[nodiscard]] particle final
+    {
+        glm::fvec2 position;
+        glm::fvec2 velocity;
+        float age;
+        float lifetime;
+        uint32_t color;
+        uint32_t padding;
+    };
+
+    // Particle of the particle shaders.
+    static_assert(std430_layout<particle, gpu_alignment<glm::fvec2>>);
+    static_assert(gpu_aligned<glm::fvec2>(offsetof(particle, velocity)));
+
+    // Particles leave the position in random directions within spread
+    // radians around the direction.
+    struct [[nodiscard]] particle_burst final
+    {
+        glm::fvec2 position;
+        glm::fvec2 direction;
+        float speed{};
+        float spread{};
+        float lifetime{};
+        glm::fvec3 color;
+        uint32_t count{};
+    };
+
+    // Shader layout of a burst, first is the index of its first particle
+    // within the particles emitted in an update.
+    struct [[nodiscard]] particle_emitter final
+    {
+        glm::fvec2 position;
+        glm::fvec2 direction;
+        float speed;
+        float spread;
+        float lifetime;
+        uint32_t color;
+        uint32_t count;
+        uint32_t first;
+    };
+
+    // Emitter of particle_emit.comp.
+    static_assert(std430_layout<particle_emitter, gpu_alignment<glm::fvec2>>);
+    static_assert(
+        gpu_aligned<glm::fvec2>(offsetof(particle_emitter, direction)));
+
+    struct [[nodiscard]] particle_snapshot final
+    {
+        std::vector<particle> particles;
+        uint32_t alive_count{};
+    };
+
+    [[nodiscard]] bool particles_match(particle const& lhs,
+        particle const& rhs);
+
+    // Emits and simulates particles on the CPU the same way the compute
+    // shaders do, used to validate the GPU results.
+    class [[nodiscard]] cpu_particle_system final
+    {
+    public: // Construction
+        explicit cpu_particle_system(uint32_t capacity);
+
+        cpu_particle_system(cpu_particle_system const&) = default;
+
+        cpu_particle_system(cpu_particle_system&&) noexcept = default;
+
+    public: // Destruction
+        ~cpu_particle_system() = default;
+
+    public: // Interface
+        void emit(particle_burst const& burst);
+
+        void update(float delta_time);
+
+        [[nodiscard]] constexpr std::span<particle const>
+        particles() const noexcept;
+
+        [[nodiscard]] constexpr uint32_t alive_count() const noexcept;
+
+    public: // Operators
+        cpu_particle_system& operator=(cpu_particle_system const&) = default;
+
+        cpu_particle_system& operator=(
+            cpu_particle_system&&) noexcept = default;
+
+    private: // Data
+        std::vector<particle> particles_;
+        std::vector<particle_burst> pending_;
+        uint32_t cursor_{};
+        uint32_t seed_{};
+        uint32_t alive_count_{};
+    };
+
+    // Particles live in a persistent device local storage buffer. Bursts
+    // are the only per update CPU work, emission, simulation and the
+    // compaction of alive particles for an indirect draw run in compute
+    // shaders.
+    class [[nodiscard]] particle_system final
+    {
+    public: // Constants
+        static constexpr uint32_t default_capacity{uint32_t{1} << 20};
+        static constexpr size_t max_emitters{256};
+
+    public: // Construction
+        // Particle storage is cleared through the queue during
+        // construction.
+        particle_system(vulkan_device* device,
+            VkQueue queue,
+            uint32_t capacity = default_capacity);
+
+        particle_system(particle_system const&) = delete;
+
+        particle_system(particle_system&&) noexcept = delete;
+
+    public: // Destruction
+        ~particle_system();
+
+    public: // Interface
+        // Bursts beyond max_emitters in one update are dropped.
+        void emit(particle_burst const& burst);
+
+        // Records emission and simulation, must be recorded outside of
+        // rendering before draw.
+        void record_update(VkCommandBuffer command_buffer,
+            uint32_t frame,
+            float delta_time);
+
+        void create_pipeline(VkFormat image_format,
+            VkSampleCountFlagBits samples,
+            bool shader_objects);
+
+        void draw(VkCommandBuffer command_buffer,
+            uint32_t frame,
+            VkExtent2D extent) const;
+
+        // Copies particle storage and the alive count of the last update
+        // to the host, waits for the queue.
+        [[nodiscard]] particle_snapshot read_back(VkQueue queue) const;
+
+        [[nodiscard]] constexpr uint32_t capacity() const noexcept;
+
+    public: // Operators
+        particle_system& operator=(particle_system const&) = delete;
+
+        particle_system& operator=(particle_system&&) noexcept = delete;
+
+    private: // Helpers
+        void create_descriptors();
+
+    private: // Data
+        vulkan_device* device_;
+        uint32_t capacity_;
+
+        vulkan_buffer particles_;
+        vulkan_buffer alive_indices_;
+        vulkan_buffer draw_command_;
+        std::array<std::optional<vulkan_buffer>,
+            vulkan_render_target::max_frames_in_flight>
+            emitters_;
+
+        VkDescriptorSetLayout descriptor_set_layout_{};
+        VkDescriptorPool descriptor_pool_{};
+        std::array<VkDescriptorSet, vulkan_render_target::max_frames_in_flight>
+            descriptor_sets_{};
+
+        std::unique_ptr<vulkan_pipeline> emit_pipeline_;
+        std::unique_ptr<vulkan_pipeline> simulate_pipeline_;
+        std::unique_ptr<vulkan_pipeline> render_pipeline_;
+
+        std::vector<particle_burst> pending_;
+        uint32_t cursor_{};
+        uint32_t seed_{};
+    };
+} // namespace vkpong
+
+inline constexpr std::span<vkpong::particle const>
+vkpong::cpu_particle_system::particles() const noexcept
+{
+    return particles_;
+}
+
+inline constexpr uint32_t
+vkpong::cpu_particle_system::alive_count() const noexcept
+{
+    return alive_count_;
+}
+
+inline constexpr uint32_t vkpong::particle_system::capacity() const noexcept
+{
+    return capacity_;
+}
+
+#endif // !VKPONG_PARTICLE_SYSTEM_INCLUDED
@@ -0,0 +1,113 @@
+#include <quad_batcher.hpp>
+
+#include <mapped_span.hpp>
+#include <vulkan_utility.hpp>
+
+#include <glm/gtc/packing.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace
+{
+    [[nodiscard]] vkpong::packed_quad_instance pack(
+        vkpong::quad_instance const& instance)
+    {
+        return {.center = glm::packHalf2x16(instance.center),
+            .half_extent = glm::packHalf2x16(instance.half_extent),
+            .color = glm::packUnorm4x8(glm::fvec4{instance.color, 1.0f})};
+    }
+
+    template<typename T, typename Transform>
+    void write_instances(vkpong::ring_allocation const& range,
+        std::span<std::vector<vkpong::quad_instance> const> const pending,
+        Transform const& transform)
+    {
+        vkpong::mapped_span<T> destination{range};
+        for (std::vector<vkpong::quad_instance> const& instances : pending)
+        {
+            for (vkpong::quad_instance const& instance : instances)
+            {
+                destination.emplace_back(transform(instance));
+            }
+        }
+    }
+} // namespace
+
+vkpong::quad_batcher::quad_batcher(ring_allocator* const ring,
+    quad_instance_format const format)
+    : ring_{ring}
+    , format_{format}
+{
+}
+
+void vkpong::quad_batcher::add_rectangle(glm::fvec2 const center,
+    glm::fvec2 const half_extent,
+    glm::fvec3 const color)
+{
+    pending_[static_cast<size_t>(quad_shape::rectangle)].push_back(
+        {.center = center, .half_extent = half_extent, .color = color});
+}
+
+void vkpong::quad_batcher::add_circle(glm::fvec2 const center,
+    glm::fvec2 const radii,
+    glm::fvec3 const color)
+{
+    pending_[static_cast<size_t>(quad_shape::circle)].push_back(
+        {.center = center, .half_extent = radii, .color = color});
+}
+
+void vkpong::quad_batcher::upload()
+{
+    batches_.clear();
+
+    size_t total{};
+    for (std::vector<quad_instance> const& instances : pending_)
+    {
+        total += instances.size();
+    }
+    if (total == 0)
+    {
+        return;
+    }
+
+    // Aligning to the stride lets the range be indexed from the start of
+    // the buffer by instance index.
+    size_t const stride{instance_size(format_)};
+    ring_allocation const range{ring_->allocate(total * stride, stride)};
+    instance_buffer_ = range.buffer;
+
+    if (format_ == quad_instance_format::packed)
+    {
+        write_instances<packed_quad_instance>(range, pending_, pack);
+    }
+    else
+    {
+        write_instances<quad_instance>(range, pending_, std::identity{});
+    }
+
+    size_t first{range.offset / stride};
+    for (size_t shape{}; shape != quad_shape_count; ++shape)
+    {
+        std::vector<quad_instance> const& instances{pending_[shape]};
+        if (instances.empty())
+        {
+            continue;
+        }
+
+        batches_.push_back({.shape = static_cast<quad_shape>(shape),
+            .first_instance = count_cast(first),
+            .instance_count = count_cast(instances.size())});
+        first += instances.size();
+    }
+}
+
+void vkpong::quad_batcher::clear() noexcept
+{
+    for (std::vector<quad_instance>& instances : pending_)
+    {
+        instances.clear();
+    }
+}
@@ -0,0 +1,153 @@
+#ifndef VKPONG_QUAD_BATCHER_INCLUDED
+#define VKPONG_QUAD_BATCHER_INCLUDED
+
+#include <gpu_layout.hpp>
+#include <ring_allocator.hpp>
+
+#include <glm/glm.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace vkpong
+{
+    enum class quad_shape : uint8_t
+    {
+        rectangle,
+        circle
+    };
+
+    inline constexpr size_t quad_shape_count{2};
+
+    struct [[nodiscard]] quad_instance final
+    {
+        glm::fvec2 center;
+        glm::fvec2 half_extent;
+        glm::fvec3 color;
+    };
+
+    enum class quad_instance_format : uint8_t
+    {
+        full,
+        packed
+    };
+
+    // Half float center and half extent, RGBA8 unorm color.
+    struct [[nodiscard]] packed_quad_instance final
+    {
+        uint32_t center;
+        uint32_t half_extent;
+        uint32_t color;
+    };
+
+    // Instances are fetched by shader.vert as 7 and 3 words.
+    static_assert(word_stream_layout<quad_instance, 7>);
+    static_assert(word_stream_layout<packed_quad_instance, 3>);
+
+    [[nodiscard]] constexpr size_t instance_size(
+        quad_instance_format format) noexcept;
+
+    struct [[nodiscard]] quad_batch final
+    {
+        quad_shape shape{};
+        uint32_t first_instance{};
+        uint32_t instance_count{};
+    };
+
+    // Collects quads submitted during a frame, groups them by shape and
+    // writes them into a range of the frame ring, one instanced draw per
+    // shape. First instances of batches are relative to the start of the
+    // instance buffer.
+    class [[nodiscard]] quad_batcher final
+    {
+    public: // Construction
+        explicit quad_batcher(ring_allocator* ring,
+            quad_instance_format format = quad_instance_format::full);
+
+        quad_batcher(quad_batcher const&) = delete;
+
+        quad_batcher(quad_batcher&&) noexcept = delete;
+
+    public: // Destruction
+        ~quad_batcher() = default;
+
+    public: // Interface
+        void add_rectangle(glm::fvec2 center,
+            glm::fvec2 half_extent,
+            glm::fvec3 color);
+
+        // Radii are given per axis so that callers can correct for the
+        // aspect ratio of the target.
+        void add_circle(glm::fvec2 center, glm::fvec2 radii, glm::fvec3 color);
+
+        // Writes submitted quads to a range of the ring allocated for the
+        // frame being recorded.
+        void upload();
+
+        // Drops submitted quads, batches stay valid until the next upload.
+        void clear() noexcept;
+
+        [[nodiscard]] constexpr std::span<quad_batch const>
+        batches() const noexcept;
+
+        // Buffer of the last upload, null before anything was uploaded.
+        [[nodiscard]] constexpr VkBuffer instance_buffer() const noexcept;
+
+        [[nodiscard]] constexpr quad_instance_format format() const noexcept;
+
+        // Takes effect on the next upload, pipelines reading the instance
+        // streams have to be built for the same format.
+        constexpr void set_format(quad_instance_format format) noexcept;
+
+    public: // Operators
+        quad_batcher& operator=(quad_batcher const&) = delete;
+
+        quad_batcher& operator=(quad_batcher&&) noexcept = delete;
+
+    private: // Data
+        ring_allocator* ring_;
+        quad_instance_format format_;
+        std::array<std::vector<quad_instance>, quad_shape_count> pending_;
+        std::vector<quad_batch> batches_;
+        VkBuffer instance_buffer_{};
+    };
+} // namespace vkpong
+
+inline constexpr size_t vkpong::instance_size(
+    quad_instance_format const format) noexcept
+{
+    return format == quad_instance_format::packed
+        ? sizeof(packed_quad_instance)
+        : sizeof(quad_instance);
+}
+
+inline constexpr std::span<vkpong::quad_batch const>
+vkpong::quad_batcher::batches() const noexcept
+{
+    return batches_;
+}
+
+inline constexpr VkBuffer
+vkpong::quad_batcher::instance_buffer() const noexcept
+{
+    return instance_buffer_;
+}
+
+inline constexpr vkpong::quad_instance_format
+vkpong::quad_batcher::format() const noexcept
+{
+    return format_;
+}
+
+inline constexpr void vkpong::quad_batcher::set_format(
+    quad_instance_format const format) noexcept
+{
+    format_ = format;
+}
+
+#endif // !VKPONG_QUAD_BATCHER_INCLUDED
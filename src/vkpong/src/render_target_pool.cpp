@@ -0,0 +1,205 @@
+#include <render_target_pool.hpp>
+
+#include <device_allocator.hpp>
+#include <host_allocator.hpp>
+#include <vulkan_device.hpp>
+#include <vulkan_utility.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    [[nodiscard]] bool matches(vkpong::attachment_description const& lhs,
+        vkpong::attachment_description const& rhs)
+    {
+        return lhs.format == rhs.format &&
+            lhs.extent.width == rhs.extent.width &&
+            lhs.extent.height == rhs.extent.height &&
+            lhs.samples == rhs.samples && lhs.usage == rhs.usage;
+    }
+
+    [[nodiscard]] VkImage create_attachment_image(VkDevice const device,
+        vkpong::attachment_description const& description)
+    {
+        VkImageCreateInfo image_info{};
+        image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_info.imageType = VK_IMAGE_TYPE_2D;
+        image_info.extent = {description.extent.width,
+            description.extent.height,
+            1};
+        image_info.mipLevels = 1;
+        image_info.arrayLayers = 1;
+        image_info.format = description.format;
+        image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image_info.usage = description.usage;
+        image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image_info.samples = description.samples;
+
+        VkImage rv{};
+        if (vkCreateImage(device,
+                &image_info,
+                vkpong::allocation_callbacks(),
+                &rv) != VK_SUCCESS)
+        {
+            throw std::runtime_error{"failed to create image!"};
+        }
+
+        return rv;
+    }
+
+    // Transient attachments never leave tile memory on tiled devices,
+    // lazily allocated memory is only committed when that doesn't hold.
+    [[nodiscard]] vkpong::memory_preference attachment_memory(
+        VkImageUsageFlags const usage)
+    {
+        if (usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
+        {
+            return {.required = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                .preferred = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+                .avoided = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT};
+        }
+
+        return vkpong::device_local_memory;
+    }
+} // namespace
+
+vkpong::render_target_pool::render_target_pool(vulkan_device* const device)
+    : device_{device}
+{
+}
+
+vkpong::render_target_pool::~render_target_pool()
+{
+    for (entry const& value : entries_)
+    {
+        assert(!value.in_use);
+        destroy(value);
+    }
+}
+
+vkpong::pooled_attachment vkpong::render_target_pool::acquire(
+    attachment_description const& description)
+{
+    auto const reusable = [&description](entry const& value)
+    { return !value.in_use && matches(value.description, description); };
+    if (auto const it{std::ranges::find_if(entries_, reusable)};
+        it != entries_.cend())
+    {
+        it->in_use = true;
+        return it->attachment;
+    }
+
+    evict_other_extents(description.extent);
+
+    VkImage const image{
+        create_attachment_image(device_->logical(), description)};
+
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(device_->logical(), image, &requirements);
+
+    entry value{.description = description, .in_use = true};
+    try
+    {
+        value.allocation = device_->allocator().allocate(requirements,
+            attachment_memory(description.usage),
+            allocation_tiling::optimal,
+            allocation_category::image,
+            image);
+    }
+    catch (...)
+    {
+        vkDestroyImage(device_->logical(), image, allocation_callbacks());
+        throw;
+    }
+
+    if (vkBindImageMemory(device_->logical(),
+            image,
+            value.allocation.memory,
+            value.allocation.offset) != VK_SUCCESS)
+    {
+        vkDestroyImage(device_->logical(), image, allocation_callbacks());
+        device_->allocator().free(value.allocation);
+        throw std::runtime_error{"failed to bind image memory!"};
+    }
+
+    value.attachment = {.image = image,
+        .view = create_image_view(device_->logical(),
+            image,
+            description.format,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            1)};
+
+    return entries_.emplace_back(std::move(value)).attachment;
+}
+
+void vkpong::render_target_pool::release(pooled_attachment& attachment)
+{
+    if (attachment.image == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    auto const it{std::ranges::find(entries_,
+        attachment.image,
+        [](entry const& value) { return value.attachment.image; })};
+    assert(it != entries_.cend() && it->in_use);
+
+    it->in_use = false;
+    it->released_at = ++generation_;
+    attachment = {};
+
+    trim();
+}
+
+void vkpong::render_target_pool::destroy(entry const& value)
+{
+    vkDestroyImageView(device_->logical(),
+        value.attachment.view,
+        allocation_callbacks());
+    vkDestroyImage(device_->logical(),
+        value.attachment.image,
+        allocation_callbacks());
+    device_->allocator().free(value.allocation);
+}
+
+void vkpong::render_target_pool::trim()
+{
+    while (std::ranges::count(entries_, false, &entry::in_use) >
+        static_cast<ptrdiff_t>(max_idle_attachments))
+    {
+        auto const oldest{std::ranges::min_element(entries_,
+            {},
+            [](entry const& value)
+            {
+                return value.in_use ? std::numeric_limits<uint64_t>::max()
+                                    : value.released_at;
+            })};
+
+        destroy(*oldest);
+        entries_.erase(oldest);
+    }
+}
+
+void vkpong::render_target_pool::evict_other_extents(VkExtent2D const extent)
+{
+    auto const stale = [extent](entry const& value)
+    {
+        return !value.in_use &&
+            (value.description.extent.width != extent.width ||
+                value.description.extent.height != extent.height);
+    };
+
+    for (entry const& value : entries_)
+    {
+        if (stale(value))
+        {
+            destroy(value);
+        }
+    }
+    std::erase_if(entries_, stale);
+}
@@ -0,0 +1,91 @@
+#ifndef VKPONG_RENDER_TARGET_POOL_INCLUDED
+#define VKPONG_RENDER_TARGET_POOL_INCLUDED
+
+#include <device_allocator.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkpong
+{
+    class vulkan_device;
+} // namespace vkpong
+
+namespace vkpong
+{
+    struct [[nodiscard]] attachment_description final
+    {
+        VkFormat format{VK_FORMAT_UNDEFINED};
+        VkExtent2D extent{};
+        VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+        VkImageUsageFlags usage{};
+    };
+
+    struct [[nodiscard]] pooled_attachment final
+    {
+        VkImage image{};
+        VkImageView view{};
+    };
+
+    // Keeps released attachments around for reuse, their memory comes
+    // from blocks of the device allocator so repeated resizes do not
+    // allocate memory. Idle attachments of other extents are dropped when
+    // an attachment of a new extent is created, after a resize they would
+    // never match again. Transient attachments prefer lazily allocated
+    // memory.
+    class [[nodiscard]] render_target_pool final
+    {
+    public: // Constants
+        static constexpr size_t max_idle_attachments{4};
+
+    public: // Construction
+        explicit render_target_pool(vulkan_device* device);
+
+        render_target_pool(render_target_pool const&) = delete;
+
+        render_target_pool(render_target_pool&&) noexcept = delete;
+
+    public: // Destruction
+        ~render_target_pool();
+
+    public: // Interface
+        [[nodiscard]] pooled_attachment acquire(
+            attachment_description const& description);
+
+        // The attachment must no longer be used by the device.
+        void release(pooled_attachment& attachment);
+
+    public: // Operators
+        render_target_pool& operator=(render_target_pool const&) = delete;
+
+        render_target_pool& operator=(render_target_pool&&) noexcept = delete;
+
+    private: // Types
+        struct [[nodiscard]] entry final
+        {
+            attachment_description description;
+            pooled_attachment attachment;
+            device_allocation allocation;
+            bool in_use{};
+            uint64_t released_at{};
+        };
+
+    private: // Helpers
+        void destroy(entry const& value);
+
+        void trim();
+
+        void evict_other_extents(VkExtent2D extent);
+
+    private: // Data
+        vulkan_device* device_;
+
+        std::vector<entry> entries_;
+        uint64_t generation_{};
+    };
+} // namespace vkpong
+
+#endif // !VKPONG_RENDER_TARGET_POOL_INCLUDED
@@ -0,0 +1,92 @@
+#include <resolution_scaler.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Weight of the newest sample in the exponential moving average.
+    constexpr double smoothing{.1};
+
+    // Frames to wait after a change so that timings at the new scale
+    // dominate the average.
+    constexpr uint32_t settle_frames{30};
+
+    // Scale up only when comfortably under budget to avoid oscillation.
+    constexpr double upscale_threshold{.8};
+    constexpr double target_utilization{.9};
+
+    [[nodiscard]] uint32_t scale_dimension(uint32_t const value,
+        float const scale)
+    {
+        auto const scaled{std::lround(static_cast<float>(value) * scale)};
+        return std::max(1u, static_cast<uint32_t>(scaled));
+    }
+} // namespace
+
+vkpong::resolution_scaler::resolution_scaler(double const budget_ms)
+    : budget_ms_{budget_ms}
+{
+}
+
+void vkpong::resolution_scaler::set_budget(double const budget_ms) noexcept
+{
+    budget_ms_ = budget_ms;
+    frames_since_change_ = 0;
+}
+
+VkExtent2D vkpong::resolution_scaler::scaled(
+    VkExtent2D const extent) const noexcept
+{
+    return {scale_dimension(extent.width, scale_),
+        scale_dimension(extent.height, scale_)};
+}
+
+bool vkpong::resolution_scaler::update(double const gpu_time_ms) noexcept
+{
+    if (gpu_time_ms <= 0)
+    {
+        return false;
+    }
+
+    smoothed_ms_ = smoothed_ms_ == 0
+        ? gpu_time_ms
+        : smoothed_ms_ + (gpu_time_ms - smoothed_ms_) * smoothing;
+
+    if (++frames_since_change_ < settle_frames)
+    {
+        return false;
+    }
+
+    bool const over_budget{smoothed_ms_ > budget_ms_};
+    bool const under_budget{smoothed_ms_ < budget_ms_ * upscale_threshold};
+    if (!over_budget && !under_budget)
+    {
+        return false;
+    }
+
+    // Fragment cost grows with the pixel count, the square of the scale.
+    double const desired{static_cast<double>(scale_) *
+        std::sqrt(budget_ms_ * target_utilization / smoothed_ms_)};
+    float const quantized{
+        std::clamp(static_cast<float>(std::round(
+                       desired / static_cast<double>(scale_step))) *
+                scale_step,
+            min_scale,
+            max_scale)};
+    if (std::abs(quantized - scale_) < scale_step / 2)
+    {
+        return false;
+    }
+
+    scale_ = quantized;
+    frames_since_change_ = 0;
+    return true;
+}
+
+void vkpong::resolution_scaler::reset() noexcept
+{
+    scale_ = max_scale;
+    smoothed_ms_ = 0;
+    frames_since_change_ = 0;
+}
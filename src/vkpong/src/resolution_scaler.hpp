@@ -0,0 +1,74 @@
+#ifndef VKPONG_RESOLUTION_SCALER_INCLUDED
+#define VKPONG_RESOLUTION_SCALER_INCLUDED
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+
+namespace vkpong
+{
+    // Picks the fraction of the output extent the scene is rendered at so
+    // that the measured GPU frame time stays within the budget.
+    class [[nodiscard]] resolution_scaler final
+    {
+    public: // Constants
+        static constexpr float min_scale{.5f};
+        static constexpr float max_scale{1.0f};
+        static constexpr float scale_step{.05f};
+
+    public: // Construction
+        explicit resolution_scaler(double budget_ms = 1000.0 / 60.0);
+
+        resolution_scaler(resolution_scaler const&) = default;
+
+        resolution_scaler(resolution_scaler&&) noexcept = default;
+
+    public: // Destruction
+        ~resolution_scaler() = default;
+
+    public: // Interface
+        [[nodiscard]] constexpr double budget() const noexcept;
+
+        void set_budget(double budget_ms) noexcept;
+
+        [[nodiscard]] constexpr float scale() const noexcept;
+
+        [[nodiscard]] constexpr double smoothed_time() const noexcept;
+
+        [[nodiscard]] VkExtent2D scaled(VkExtent2D extent) const noexcept;
+
+        // Returns true when the scale changed.
+        bool update(double gpu_time_ms) noexcept;
+
+        void reset() noexcept;
+
+    public: // Operators
+        resolution_scaler& operator=(resolution_scaler const&) = default;
+
+        resolution_scaler& operator=(resolution_scaler&&) noexcept = default;
+
+    private: // Data
+        double budget_ms_;
+        float scale_{max_scale};
+        double smoothed_ms_{};
+        uint32_t frames_since_change_{};
+    };
+} // namespace vkpong
+
+inline constexpr double vkpong::resolution_scaler::budget() const noexcept
+{
+    return budget_ms_;
+}
+
+inline constexpr float vkpong::resolution_scaler::scale() const noexcept
+{
+    return scale_;
+}
+
+inline constexpr double
+vkpong::resolution_scaler::smoothed_time() const noexcept
+{
+    return smoothed_ms_;
+}
+
+#endif // !VKPONG_RESOLUTION_SCALER_INCLUDED
@@ -0,0 +1,110 @@
+#include <ring_allocator.hpp>
+
+#include <vulkan_utility.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <utility>
+
+namespace
+{
+    [[nodiscard]] vkpong::vulkan_buffer create_ring_buffer(
+        vkpong::vulkan_device* const device,
+        VkBufferUsageFlags const usage,
+        VkDeviceSize const capacity)
+    {
+        return {device,
+            capacity,
+            usage,
+            vkpong::dynamic_memory};
+    }
+} // namespace
+
+vkpong::ring_allocator::ring_allocator(vulkan_device* const device,
+    VkBufferUsageFlags const usage,
+    VkDeviceSize const capacity)
+    : device_{device}
+    , usage_{usage}
+    , buffer_{create_ring_buffer(device, usage, capacity)}
+{
+}
+
+void vkpong::ring_allocator::begin_frame(uint32_t const frame)
+{
+    std::erase_if(retired_,
+        [](retired_buffer& retired)
+        { return --retired.remaining_frames == 0; });
+
+    frame_ = frame;
+    frame_starts_[frame_] = head_;
+
+    // Frame slots are used round robin, the oldest frame still in flight
+    // is the first one after the current slot that was started.
+    tail_ = head_;
+    for (size_t i{1}; i != frame_starts_.size(); ++i)
+    {
+        size_t const slot{(frame_ + i) % frame_starts_.size()};
+        if (frame_starts_[slot])
+        {
+            tail_ = *frame_starts_[slot];
+            break;
+        }
+    }
+}
+
+vkpong::ring_allocation vkpong::ring_allocator::allocate(
+    VkDeviceSize const size,
+    VkDeviceSize const alignment)
+{
+    assert(alignment != 0);
+
+    auto const place = [this, size, alignment]() -> VkDeviceSize
+    {
+        VkDeviceSize const capacity{buffer_.size()};
+        VkDeviceSize const offset{head_ % capacity};
+        VkDeviceSize const aligned{
+            (offset + alignment - 1) / alignment * alignment};
+        if (aligned + size <= capacity)
+        {
+            return head_ - offset + aligned;
+        }
+
+        // Ranges don't wrap around the end of the buffer.
+        return head_ - offset + capacity;
+    };
+
+    VkDeviceSize position{place()};
+    if (position + size - tail_ > buffer_.size())
+    {
+        grow(size);
+        position = place();
+    }
+
+    head_ = position + size;
+
+    VkDeviceSize const offset{position % buffer_.size()};
+    buffer_.mark_written(offset, size);
+    return {.buffer = buffer_.buffer(),
+        .offset = offset,
+        .size = size,
+        .data = buffer_.mapped_bytes().data() + offset};
+}
+
+void vkpong::ring_allocator::grow(VkDeviceSize const size)
+{
+    // Frames in flight, including the one being recorded, may use the
+    // current buffer until their slots are begun again.
+    retired_.push_back({.buffer = std::move(buffer_),
+        .remaining_frames =
+            count_cast(vulkan_render_target::max_frames_in_flight)});
+
+    buffer_ = create_ring_buffer(device_,
+        usage_,
+        std::bit_ceil(std::max(2 * retired_.back().buffer.size(), size)));
+
+    head_ = 0;
+    tail_ = 0;
+    frame_starts_.fill(std::nullopt);
+    frame_starts_[frame_] = 0;
+}
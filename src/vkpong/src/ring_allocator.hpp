@@ -0,0 +1,108 @@
+#ifndef VKPONG_RING_ALLOCATOR_INCLUDED
+#define VKPONG_RING_ALLOCATOR_INCLUDED
+
+#include <vulkan_buffer.hpp>
+#include <vulkan_render_target.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace vkpong
+{
+    class vulkan_device;
+} // namespace vkpong
+
+namespace vkpong
+{
+    struct [[nodiscard]] ring_allocation final
+    {
+        VkBuffer buffer{};
+        VkDeviceSize offset{};
+        VkDeviceSize size{};
+        std::byte* data{};
+    };
+
+    // Hands out ranges of a persistently mapped buffer to the frame being
+    // recorded by bumping a pointer. Ranges of a frame slot are reclaimed
+    // when the slot is begun again. When the ring is full the buffer is
+    // replaced with a larger one, the old buffer is kept alive until all
+    // frames in flight using it retire.
+    class [[nodiscard]] ring_allocator final
+    {
+    public: // Constants
+        static constexpr VkDeviceSize default_capacity{VkDeviceSize{4} << 20};
+
+    public: // Construction
+        ring_allocator(vulkan_device* device,
+            VkBufferUsageFlags usage,
+            VkDeviceSize capacity = default_capacity);
+
+        ring_allocator(ring_allocator const&) = delete;
+
+        ring_allocator(ring_allocator&&) noexcept = delete;
+
+    public: // Destruction
+        ~ring_allocator() = default;
+
+    public: // Interface
+        // The previous use of the frame slot must have completed on the
+        // device.
+        void begin_frame(uint32_t frame);
+
+        // Alignment doesn't have to be a power of two, ranges indexed as
+        // arrays of a structure are aligned to the structure size.
+        [[nodiscard]] ring_allocation allocate(VkDeviceSize size,
+            VkDeviceSize alignment);
+
+        [[nodiscard]] constexpr VkBuffer buffer() const noexcept;
+
+        [[nodiscard]] constexpr VkDeviceSize capacity() const noexcept;
+
+    public: // Operators
+        ring_allocator& operator=(ring_allocator const&) = delete;
+
+        ring_allocator& operator=(ring_allocator&&) noexcept = delete;
+
+    private: // Types
+        struct [[nodiscard]] retired_buffer final
+        {
+            vulkan_buffer buffer;
+            uint32_t remaining_frames{};
+        };
+
+    private: // Helpers
+        void grow(VkDeviceSize size);
+
+    private: // Data
+        vulkan_device* device_;
+        VkBufferUsageFlags usage_;
+        vulkan_buffer buffer_;
+        std::vector<retired_buffer> retired_;
+
+        // Positions only increase, offsets are positions modulo capacity.
+        VkDeviceSize head_{};
+        VkDeviceSize tail_{};
+        uint32_t frame_{};
+        std::array<std::optional<VkDeviceSize>,
+            vulkan_render_target::max_frames_in_flight>
+            frame_starts_;
+    };
+} // namespace vkpong
+
+inline constexpr VkBuffer vkpong::ring_allocator::buffer() const noexcept
+{
+    return buffer_.buffer();
+}
+
+inline constexpr VkDeviceSize
+vkpong::ring_allocator::capacity() const noexcept
+{
+    return buffer_.size();
+}
+
+#endif // !VKPONG_RING_ALLOCATOR_INCLUDED
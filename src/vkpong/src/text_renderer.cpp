@@ -0,0 +1,517 @@
+#include <text_renderer.hpp>
+
+#include <device_allocator.hpp>
+#include <host_allocator.hpp>
+#include <mapped_span.hpp>
+#include <upload_manager.hpp>
+#include <vulkan_device.hpp>
+#include <vulkan_pipeline.hpp>
+#include <vulkan_utility.hpp>
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    // Glyphs of the embedded 5x7 bitmap font, rows from the top with the
+    // leftmost pixel in the highest of the five bits.
+    constexpr std::string_view glyph_characters{
+        " 0123456789:-.ABCDEFGHIJKLMNOPQRSTUVWXYZ"};
+
+    constexpr uint32_t glyph_width{5};
+    constexpr uint32_t glyph_height{7};
+
+    using glyph_bitmap = std::array<uint8_t, glyph_height>;
+
+    constexpr std::array<glyph_bitmap, glyph_characters.size()> glyph_bitmaps{
+        {{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+            {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E},
+            {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E},
+            {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F},
+            {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E},
+            {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02},
+            {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E},
+            {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E},
+            {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08},
+            {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E},
+            {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C},
+            {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00},
+            {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00},
+            {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C},
+            {0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11},
+            {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E},
+            {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E},
+            {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C},
+            {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F},
+            {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10},
+            {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F},
+            {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11},
+            {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E},
+            {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C},
+            {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11},
+            {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F},
+            {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11},
+            {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11},
+            {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},
+            {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10},
+            {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D},
+            {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11},
+            {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E},
+            {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04},
+            {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},
+            {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04},
+            {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A},
+            {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11},
+            {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04},
+            {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}}};
+
+    // Atlas texels per font pixel, the padding around each glyph is one
+    // font pixel wide and holds the outside of the distance field.
+    constexpr uint32_t texels_per_pixel{4};
+    constexpr uint32_t cell_padding{texels_per_pixel};
+    constexpr uint32_t cell_width{glyph_width * texels_per_pixel +
+        2 * cell_padding};
+    constexpr uint32_t cell_height{glyph_height * texels_per_pixel +
+        2 * cell_padding};
+    constexpr uint32_t atlas_columns{8};
+    constexpr uint32_t atlas_rows{
+        (glyph_characters.size() + atlas_columns - 1) / atlas_columns};
+    constexpr VkExtent2D atlas_extent{atlas_columns * cell_width,
+        atlas_rows * cell_height};
+
+    constexpr uint32_t quad_vertex_count{6};
+
+    struct [[nodiscard]] push_constants final
+    {
+        glm::fvec2 cell_scale;
+        glm::fvec2 atlas_cell;
+    };
+
+    [[nodiscard]] bool glyph_pixel(glyph_bitmap const& bitmap,
+        int const x,
+        int const y)
+    {
+        if (x < 0 || y < 0 || x >= static_cast<int>(glyph_width) ||
+            y >= static_cast<int>(glyph_height))
+        {
+            return false;
+        }
+
+        auto const column{static_cast<uint32_t>(x)};
+        return (bitmap[static_cast<size_t>(y)] >> (glyph_width - 1 - column)) &
+            1;
+    }
+
+    // Signed distance in font pixels from the point to the nearest edge of
+    // the glyph, positive inside, clamped to one pixel.
+    [[nodiscard]] float glyph_distance(glyph_bitmap const& bitmap,
+        float const x,
+        float const y)
+    {
+        bool const inside{glyph_pixel(bitmap,
+            static_cast<int>(std::floor(x)),
+            static_cast<int>(std::floor(y)))};
+
+        float rv{1.0f};
+        for (int py{-1}; py <= static_cast<int>(glyph_height); ++py)
+        {
+            for (int px{-1}; px <= static_cast<int>(glyph_width); ++px)
+            {
+                if (glyph_pixel(bitmap, px, py) == inside)
+                {
+                    continue;
+                }
+
+                float const dx{std::max({static_cast<float>(px) - x,
+                    0.0f,
+                    x - static_cast<float>(px + 1)})};
+                float const dy{std::max({static_cast<float>(py) - y,
+                    0.0f,
+                    y - static_cast<float>(py + 1)})};
+                rv = std::min(rv, std::sqrt(dx * dx + dy * dy));
+            }
+        }
+
+        return inside ? rv : -rv;
+    }
+
+    [[nodiscard]] std::vector<uint8_t> bake_atlas()
+    {
+        std::vector<uint8_t> rv(
+            size_t{atlas_extent.width} * atlas_extent.height);
+
+        for (size_t glyph{}; glyph != glyph_bitmaps.size(); ++glyph)
+        {
+            uint32_t const cell_x{
+                static_cast<uint32_t>(glyph % atlas_columns) * cell_width};
+            uint32_t const cell_y{
+                static_cast<uint32_t>(glyph / atlas_columns) * cell_height};
+
+            for (uint32_t y{}; y != cell_height; ++y)
+            {
+                for (uint32_t x{}; x != cell_width; ++x)
+                {
+                    auto const to_pixels = [](uint32_t const texel)
+                    {
+                        return (static_cast<float>(texel) + 0.5f -
+                                   static_cast<float>(cell_padding)) /
+                            static_cast<float>(texels_per_pixel);
+                    };
+
+                    float const distance{glyph_distance(glyph_bitmaps[glyph],
+                        to_pixels(x),
+                        to_pixels(y))};
+                    rv[size_t{cell_y + y} * atlas_extent.width + cell_x + x] =
+                        static_cast<uint8_t>(
+                            std::lround((0.5f + distance * 0.5f) * 255.0f));
+                }
+            }
+        }
+
+        return rv;
+    }
+
+    [[nodiscard]] uint32_t glyph_index(char const character)
+    {
+        size_t const index{glyph_characters.find(static_cast<char>(
+            std::toupper(static_cast<unsigned char>(character))))};
+        return index == std::string_view::npos ? 0 : vkpong::count_cast(index);
+    }
+} // namespace
+
+vkpong::text_renderer::text_renderer(vulkan_device* const device,
+    upload_manager& uploads)
+    : device_{device}
+{
+    create_atlas(uploads);
+    create_descriptors();
+
+    for (uint32_t i{}; i != streams_.size(); ++i)
+    {
+        streams_[i].emplace(device_,
+            initial_capacity * sizeof(glyph_instance),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            dynamic_memory);
+        bind_instances(i);
+    }
+}
+
+vkpong::text_renderer::~text_renderer()
+{
+    pipeline_.reset();
+
+    vkDestroyDescriptorPool(device_->logical(),
+        descriptor_pool_,
+        allocation_callbacks());
+    vkDestroyDescriptorSetLayout(device_->logical(),
+        descriptor_set_layout_,
+        allocation_callbacks());
+
+    vkDestroySampler(device_->logical(), sampler_, allocation_callbacks());
+    vkDestroyImageView(device_->logical(), atlas_view_, allocation_callbacks());
+    vkDestroyImage(device_->logical(), atlas_image_, allocation_callbacks());
+    device_->allocator().free(atlas_memory_);
+}
+
+size_t vkpong::text_renderer::add_text(glm::fvec2 const position,
+    float const size,
+    glm::fvec3 const color)
+{
+    entries_.push_back({.position = position,
+        .size = size,
+        .color = glm::packUnorm4x8(glm::fvec4{color, 1.0f})});
+    return entries_.size() - 1;
+}
+
+void vkpong::text_renderer::set_text(size_t const handle,
+    std::string_view const text)
+{
+    text_entry& entry{entries_[handle]};
+    if (entry.text == text)
+    {
+        return;
+    }
+
+    glyph_count_ -= entry.glyph_count;
+    entry.text = text;
+    entry.glyph_count = static_cast<size_t>(std::ranges::count_if(text,
+        [](char const c) { return glyph_index(c) != 0; }));
+    glyph_count_ += entry.glyph_count;
+    ++version_;
+}
+
+void vkpong::text_renderer::upload(uint32_t const frame)
+{
+    if (uploaded_versions_[frame] == version_)
+    {
+        return;
+    }
+
+    std::optional<vulkan_buffer>& stream{streams_[frame]};
+    if (stream->size() < glyph_count_ * sizeof(glyph_instance))
+    {
+        stream.reset();
+        stream.emplace(device_,
+            std::bit_ceil(glyph_count_) * sizeof(glyph_instance),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            dynamic_memory);
+        bind_instances(frame);
+    }
+
+    mapped_span<glyph_instance> glyphs{*stream, 0, glyph_count_};
+    for (text_entry const& entry : entries_)
+    {
+        for (size_t i{}; i != entry.text.size(); ++i)
+        {
+            if (uint32_t const glyph{glyph_index(entry.text[i])}; glyph != 0)
+            {
+                glyphs.emplace_back(glyph_instance{.origin = entry.position,
+                    .size = entry.size,
+                    .column = count_cast(i),
+                    .glyph = glyph,
+                    .color = entry.color});
+            }
+        }
+    }
+    uploaded_versions_[frame] = version_;
+}
+
+void vkpong::text_renderer::create_pipeline(VkFormat const image_format,
+    VkSampleCountFlagBits const samples,
+    bool const shader_objects)
+{
+    vulkan_pipeline_builder builder{device_, image_format};
+    if (shader_objects)
+    {
+        builder.with_shader_objects();
+    }
+    pipeline_ = std::make_unique<vulkan_pipeline>(
+        builder.add_shader(VK_SHADER_STAGE_VERTEX_BIT, "text_vert.spv", "main")
+            .add_shader(VK_SHADER_STAGE_FRAGMENT_BIT, "text_frag.spv", "main")
+            .add_descriptor_set_layout(descriptor_set_layout_)
+            .with_rasterization_samples(samples)
+            .with_push_constants(VkPushConstantRange{
+                .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+                .offset = 0,
+                .size = sizeof(push_constants)})
+            .with_color_blending(VkPipelineColorBlendAttachmentState{
+                .blendEnable = VK_TRUE,
+                .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
+                .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+                .colorBlendOp = VK_BLEND_OP_ADD,
+                .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+                .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+                .alphaBlendOp = VK_BLEND_OP_ADD,
+                .colorWriteMask = VK_COLOR_COMPONENT_R_BIT |
+                    VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT |
+                    VK_COLOR_COMPONENT_A_BIT})
+            .build());
+}
+
+void vkpong::text_renderer::draw(VkCommandBuffer const command_buffer,
+    uint32_t const frame,
+    VkExtent2D const extent) const
+{
+    if (glyph_count_ == 0)
+    {
+        return;
+    }
+
+    VkViewport viewport{};
+    viewport.width = static_cast<float>(extent.width);
+    viewport.height = static_cast<float>(extent.height);
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewportWithCount(command_buffer, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.extent = extent;
+    vkCmdSetScissorWithCount(command_buffer, 1, &scissor);
+
+    pipeline_->bind(command_buffer);
+    vkCmdBindDescriptorSets(command_buffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        pipeline_->pipeline_layout(),
+        0,
+        1,
+        &descriptor_sets_[frame],
+        0,
+        nullptr);
+
+    // Glyph width in normalized device coordinates relative to its height
+    // keeps glyphs undistorted at any aspect ratio.
+    push_constants const constants{
+        .cell_scale = {static_cast<float>(cell_width) * viewport.height /
+                (static_cast<float>(cell_height) * viewport.width),
+            1.0f},
+        .atlas_cell = {1.0f / atlas_columns, 1.0f / atlas_rows}};
+    vkCmdPushConstants(command_buffer,
+        pipeline_->pipeline_layout(),
+        VK_SHADER_STAGE_VERTEX_BIT,
+        0,
+        sizeof(push_constants),
+        &constants);
+
+    vkCmdDraw(command_buffer,
+        quad_vertex_count,
+        count_cast(glyph_count_),
+        0,
+        0);
+}
+
+void vkpong::text_renderer::create_atlas(upload_manager& uploads)
+{
+    std::vector<uint8_t> const texels{bake_atlas()};
+
+    create_image(device_->allocator(),
+        device_->logical(),
+        atlas_extent,
+        1,
+        VK_SAMPLE_COUNT_1_BIT,
+        VK_FORMAT_R8_UNORM,
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        device_local_memory,
+        atlas_image_,
+        atlas_memory_);
+    atlas_view_ = create_image_view(device_->logical(),
+        atlas_image_,
+        VK_FORMAT_R8_UNORM,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        1);
+
+    VkSamplerCreateInfo sampler_info{};
+    sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    sampler_info.magFilter = VK_FILTER_LINEAR;
+    sampler_info.minFilter = VK_FILTER_LINEAR;
+    sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    if (vkCreateSampler(device_->logical(),
+            &sampler_info,
+            allocation_callbacks(),
+            &sampler_) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to create sampler!"};
+    }
+
+    uploads.upload(atlas_image_,
+        atlas_extent,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        as_bytes(texels));
+}
+
+void vkpong::text_renderer::create_descriptors()
+{
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.bindingCount = count_cast(bindings.size());
+    layout_info.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(device_->logical(),
+            &layout_info,
+            allocation_callbacks(),
+            &descriptor_set_layout_) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to create descriptor set layout!"};
+    }
+
+    constexpr auto count{
+        count_cast(vulkan_render_target::max_frames_in_flight)};
+    std::array const pool_sizes{
+        VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = count},
+        VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = count}};
+
+    VkDescriptorPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.poolSizeCount = count_cast(pool_sizes.size());
+    pool_info.pPoolSizes = pool_sizes.data();
+    pool_info.maxSets = count;
+    if (vkCreateDescriptorPool(device_->logical(),
+            &pool_info,
+            allocation_callbacks(),
+            &descriptor_pool_) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to create descriptor pool!"};
+    }
+
+    std::array<VkDescriptorSetLayout,
+        vulkan_render_target::max_frames_in_flight>
+        layouts{};
+    layouts.fill(descriptor_set_layout_);
+
+    VkDescriptorSetAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.descriptorPool = descriptor_pool_;
+    alloc_info.descriptorSetCount = count;
+    alloc_info.pSetLayouts = layouts.data();
+    if (vkAllocateDescriptorSets(device_->logical(),
+            &alloc_info,
+            descriptor_sets_.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to allocate descriptor sets!"};
+    }
+
+    VkDescriptorImageInfo image_info{};
+    image_info.sampler = sampler_;
+    image_info.imageView = atlas_view_;
+    image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    for (VkDescriptorSet const descriptor_set : descriptor_sets_)
+    {
+        VkWriteDescriptorSet descriptor_write{};
+        descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_write.dstSet = descriptor_set;
+        descriptor_write.dstBinding = 1;
+        descriptor_write.descriptorType =
+            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        descriptor_write.descriptorCount = 1;
+        descriptor_write.pImageInfo = &image_info;
+
+        vkUpdateDescriptorSets(device_->logical(),
+            1,
+            &descriptor_write,
+            0,
+            nullptr);
+    }
+}
+
+void vkpong::text_renderer::bind_instances(uint32_t const frame)
+{
+    VkDescriptorBufferInfo buffer_info{};
+    buffer_info.buffer = streams_[frame]->buffer();
+    buffer_info.offset = 0;
+    buffer_info.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet descriptor_write{};
+    descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptor_write.dstSet = descriptor_sets_[frame];
+    descriptor_write.dstBinding = 0;
+    descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptor_write.descriptorCount = 1;
+    descriptor_write.pBufferInfo = &buffer_info;
+
+    vkUpdateDescriptorSets(device_->logical(),
+        1,
+        &descriptor_write,
+        0,
+        nullptr);
+}
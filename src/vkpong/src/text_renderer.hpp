@@ -0,0 +1,138 @@
+#ifndef VKPONG_TEXT_RENDERER_INCLUDED
+#define VKPONG_TEXT_RENDERER_INCLUDED
+
+#include <device_allocator.hpp>
+#include <gpu_layout.hpp>
+#include <vulkan_buffer.hpp>
+#include <vulkan_render_target.hpp>
+
+#include <glm/glm.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vkpong
+{
+    class upload_manager;
+    class vulkan_device;
+    class vulkan_pipeline;
+} // namespace vkpong
+
+namespace vkpong
+{
+    struct [[nodiscard]] glyph_instance final
+    {
+        glm::fvec2 origin;
+        float size;
+        uint32_t column;
+        uint32_t glyph;
+        uint32_t color;
+    };
+
+    // Instances are fetched by text.vert as 6 words.
+    static_assert(word_stream_layout<glyph_instance, 6>);
+
+    // Draws strings as instanced quads sampling a signed distance field
+    // glyph atlas. Glyph instances of a string are rebuilt only when its
+    // text changes, all strings are drawn with a single draw call.
+    class [[nodiscard]] text_renderer final
+    {
+    public: // Constants
+        static constexpr size_t initial_capacity{256};
+
+    public: // Construction
+        // The atlas upload is queued during construction, it is usable
+        // once the uploads are submitted.
+        text_renderer(vulkan_device* device, upload_manager& uploads);
+
+        text_renderer(text_renderer const&) = delete;
+
+        text_renderer(text_renderer&&) noexcept = delete;
+
+    public: // Destruction
+        ~text_renderer();
+
+    public: // Interface
+        // Position is the top left corner in normalized device coordinates,
+        // size is the glyph height. Returns a handle for set_text.
+        [[nodiscard]] size_t add_text(glm::fvec2 position,
+            float size,
+            glm::fvec3 color);
+
+        void set_text(size_t handle, std::string_view text);
+
+        // Writes glyph instances of the frame slot if any text changed
+        // since the slot was last written.
+        void upload(uint32_t frame);
+
+        void create_pipeline(VkFormat image_format,
+            VkSampleCountFlagBits samples,
+            bool shader_objects);
+
+        void draw(VkCommandBuffer command_buffer,
+            uint32_t frame,
+            VkExtent2D extent) const;
+
+        [[nodiscard]] constexpr size_t glyph_count() const noexcept;
+
+    public: // Operators
+        text_renderer& operator=(text_renderer const&) = delete;
+
+        text_renderer& operator=(text_renderer&&) noexcept = delete;
+
+    private: // Types
+        struct [[nodiscard]] text_entry final
+        {
+            glm::fvec2 position;
+            float size{};
+            uint32_t color{};
+            std::string text;
+            size_t glyph_count{};
+        };
+
+    private: // Helpers
+        void create_atlas(upload_manager& uploads);
+
+        void create_descriptors();
+
+        void bind_instances(uint32_t frame);
+
+    private: // Data
+        vulkan_device* device_;
+
+        VkImage atlas_image_{};
+        device_allocation atlas_memory_;
+        VkImageView atlas_view_{};
+        VkSampler sampler_{};
+
+        VkDescriptorSetLayout descriptor_set_layout_{};
+        VkDescriptorPool descriptor_pool_{};
+        std::array<VkDescriptorSet, vulkan_render_target::max_frames_in_flight>
+            descriptor_sets_{};
+        std::unique_ptr<vulkan_pipeline> pipeline_;
+
+        std::vector<text_entry> entries_;
+        size_t glyph_count_{};
+        uint64_t version_{};
+        std::array<uint64_t, vulkan_render_target::max_frames_in_flight>
+            uploaded_versions_{};
+        std::array<std::optional<vulkan_buffer>,
+            vulkan_render_target::max_frames_in_flight>
+            streams_;
+    };
+} // namespace vkpong
+
+inline constexpr size_t vkpong::text_renderer::glyph_count() const noexcept
+{
+    return glyph_count_;
+}
+
+#endif // !VKPONG_TEXT_RENDERER_INCLUDED
@@ -0,0 +1,333 @@
+#include <upload_manager.hpp>
+
+#include <device_allocator.hpp>
+#include <host_allocator.hpp>
+#include <vulkan_device.hpp>
+#include <vulkan_utility.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    constexpr VkImageSubresourceRange color_subresource{
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = 0,
+        .levelCount = 1,
+        .baseArrayLayer = 0,
+        .layerCount = 1};
+
+    void pipeline_barrier(VkCommandBuffer const command_buffer,
+        std::span<VkBufferMemoryBarrier2 const> const buffer_barriers,
+        std::span<VkImageMemoryBarrier2 const> const image_barriers)
+    {
+        VkDependencyInfo dependency{};
+        dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency.bufferMemoryBarrierCount =
+            vkpong::count_cast(buffer_barriers.size());
+        dependency.pBufferMemoryBarriers = buffer_barriers.data();
+        dependency.imageMemoryBarrierCount =
+            vkpong::count_cast(image_barriers.size());
+        dependency.pImageMemoryBarriers = image_barriers.data();
+
+        vkCmdPipelineBarrier2(command_buffer, &dependency);
+    }
+} // namespace
+
+vkpong::upload_manager::upload_manager(vulkan_device* const device)
+    : device_{device}
+    , dedicated_queue_{device->transfer_family() != device->graphics_family()}
+    , semaphore_{create_timeline_semaphore(device->logical(), 0)}
+{
+    vkGetDeviceQueue(device_->logical(),
+        device_->transfer_family(),
+        0,
+        &queue_);
+
+    VkCommandPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    pool_info.queueFamilyIndex = device_->transfer_family();
+
+    if (vkCreateCommandPool(device_->logical(),
+            &pool_info,
+            allocation_callbacks(),
+            &command_pool_) != VK_SUCCESS)
+    {
+        vkDestroySemaphore(device_->logical(),
+            semaphore_,
+            allocation_callbacks());
+        throw std::runtime_error{"failed to create command pool!"};
+    }
+}
+
+vkpong::upload_manager::~upload_manager()
+{
+    // Recorded but never submitted uploads are dropped.
+    wait();
+
+    vkDestroyCommandPool(device_->logical(),
+        command_pool_,
+        allocation_callbacks());
+    vkDestroySemaphore(device_->logical(), semaphore_, allocation_callbacks());
+}
+
+void vkpong::upload_manager::upload(vulkan_buffer& buffer,
+    VkDeviceSize const offset,
+    std::span<std::byte const> const bytes)
+{
+    if (buffer.host_visible())
+    {
+        buffer.fill(offset, bytes);
+        return;
+    }
+
+    VkCommandBuffer const command_buffer{recording_command_buffer()};
+    vulkan_buffer const& staging{stage(bytes)};
+
+    VkBufferCopy const region{.srcOffset = 0,
+        .dstOffset = offset,
+        .size = bytes.size()};
+    vkCmdCopyBuffer(command_buffer,
+        staging.buffer(),
+        buffer.buffer(),
+        1,
+        &region);
+
+    // Without a dedicated queue the barrier orders the copy before every
+    // later submission, not only the one waiting on the semaphore.
+    // Otherwise ownership of the range is released to the graphics queue
+    // and the acquire makes the copy visible to it.
+    VkBufferMemoryBarrier2 release{};
+    release.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+    release.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+    release.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    release.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    release.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+    release.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    release.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    release.buffer = buffer.buffer();
+    release.offset = offset;
+    release.size = bytes.size();
+    if (dedicated_queue_)
+    {
+        release.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+        release.dstAccessMask = VK_ACCESS_2_NONE;
+        release.srcQueueFamilyIndex = device_->transfer_family();
+        release.dstQueueFamilyIndex = device_->graphics_family();
+    }
+    pipeline_barrier(command_buffer, {&release, 1}, {});
+
+    if (!dedicated_queue_)
+    {
+        return;
+    }
+
+    VkBufferMemoryBarrier2& acquire{buffer_acquires_.emplace_back(release)};
+    acquire.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+    acquire.srcAccessMask = VK_ACCESS_2_NONE;
+    acquire.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    acquire.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+}
+
+void vkpong::upload_manager::upload(VkImage const image,
+    VkExtent2D const extent,
+    VkImageLayout const layout,
+    std::span<std::byte const> const bytes)
+{
+    VkCommandBuffer const command_buffer{recording_command_buffer()};
+    vulkan_buffer const& staging{stage(bytes)};
+
+    VkImageMemoryBarrier2 to_transfer{};
+    to_transfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+    to_transfer.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+    to_transfer.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    to_transfer.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    to_transfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    to_transfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    to_transfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    to_transfer.image = image;
+    to_transfer.subresourceRange = color_subresource;
+    pipeline_barrier(command_buffer, {}, {&to_transfer, 1});
+
+    VkBufferImageCopy region{};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = {extent.width, extent.height, 1};
+    vkCmdCopyBufferToImage(command_buffer,
+        staging.buffer(),
+        image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1,
+        &region);
+
+    // Without a dedicated queue this is a plain layout transition which
+    // every later submission reading the image is ordered after.
+    // Otherwise the transition is part of the ownership transfer, the
+    // acquire repeats the layouts of the release and the transition
+    // executes once.
+    VkImageMemoryBarrier2 release{to_transfer};
+    release.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+    release.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    release.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    release.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+    release.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    release.newLayout = layout;
+    if (dedicated_queue_)
+    {
+        release.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+        release.dstAccessMask = VK_ACCESS_2_NONE;
+        release.srcQueueFamilyIndex = device_->transfer_family();
+        release.dstQueueFamilyIndex = device_->graphics_family();
+    }
+    pipeline_barrier(command_buffer, {}, {&release, 1});
+
+    if (dedicated_queue_)
+    {
+        VkImageMemoryBarrier2& acquire{image_acquires_.emplace_back(release)};
+        acquire.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+        acquire.srcAccessMask = VK_ACCESS_2_NONE;
+        acquire.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        acquire.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+    }
+}
+
+std::optional<VkSemaphoreSubmitInfo> vkpong::upload_manager::submit()
+{
+    release_completed();
+
+    if (command_buffer_ == VK_NULL_HANDLE)
+    {
+        return std::nullopt;
+    }
+
+    if (vkEndCommandBuffer(command_buffer_) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"unable to end command buffer recording!"};
+    }
+
+    device_->allocator().flush_pending();
+
+    VkCommandBufferSubmitInfo command_buffer_info{};
+    command_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+    command_buffer_info.commandBuffer = command_buffer_;
+
+    VkSemaphoreSubmitInfo signal_info{};
+    signal_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    signal_info.semaphore = semaphore_;
+    signal_info.value = value_ + 1;
+    signal_info.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+    VkSubmitInfo2 submit_info{};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+    submit_info.commandBufferInfoCount = 1;
+    submit_info.pCommandBufferInfos = &command_buffer_info;
+    submit_info.signalSemaphoreInfoCount = 1;
+    submit_info.pSignalSemaphoreInfos = &signal_info;
+
+    if (vkQueueSubmit2(queue_, 1, &submit_info, VK_NULL_HANDLE) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to submit upload command buffer!"};
+    }
+
+    ++value_;
+    submitted_.push_back({.value = value_,
+        .command_buffer = std::exchange(command_buffer_, VK_NULL_HANDLE),
+        .staging = std::move(staging_)});
+    staging_.clear();
+
+    return signal_info;
+}
+
+void vkpong::upload_manager::record_acquire(
+    VkCommandBuffer const command_buffer)
+{
+    if (buffer_acquires_.empty() && image_acquires_.empty())
+    {
+        return;
+    }
+
+    pipeline_barrier(command_buffer, buffer_acquires_, image_acquires_);
+
+    buffer_acquires_.clear();
+    image_acquires_.clear();
+}
+
+void vkpong::upload_manager::wait()
+{
+    VkSemaphoreWaitInfo wait_info{};
+    wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    wait_info.semaphoreCount = 1;
+    wait_info.pSemaphores = &semaphore_;
+    wait_info.pValues = &value_;
+    vkWaitSemaphores(device_->logical(),
+        &wait_info,
+        std::numeric_limits<uint64_t>::max());
+
+    release_completed();
+}
+
+VkCommandBuffer vkpong::upload_manager::recording_command_buffer()
+{
+    if (command_buffer_ != VK_NULL_HANDLE)
+    {
+        return command_buffer_;
+    }
+
+    VkCommandBufferAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    alloc_info.commandPool = command_pool_;
+    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    alloc_info.commandBufferCount = 1;
+
+    if (vkAllocateCommandBuffers(device_->logical(),
+            &alloc_info,
+            &command_buffer_) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to allocate command buffers!"};
+    }
+
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(command_buffer_, &begin_info) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"unable to begin command buffer recording!"};
+    }
+
+    return command_buffer_;
+}
+
+vkpong::vulkan_buffer& vkpong::upload_manager::stage(
+    std::span<std::byte const> const bytes)
+{
+    vulkan_buffer& rv{staging_.emplace_back(device_,
+        bytes.size(),
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        staging_memory)};
+    rv.fill(0, bytes);
+    return rv;
+}
+
+void vkpong::upload_manager::release_completed()
+{
+    uint64_t completed{};
+    vkGetSemaphoreCounterValue(device_->logical(), semaphore_, &completed);
+
+    std::erase_if(submitted_,
+        [this, completed](submitted_batch const& batch)
+        {
+            if (batch.value > completed)
+            {
+                return false;
+            }
+
+            vkFreeCommandBuffers(device_->logical(),
+                command_pool_,
+                1,
+                &batch.command_buffer);
+            return true;
+        });
+}
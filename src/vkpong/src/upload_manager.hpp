@@ -0,0 +1,106 @@
+#ifndef VKPONG_UPLOAD_MANAGER_INCLUDED
+#define VKPONG_UPLOAD_MANAGER_INCLUDED
+
+#include <vulkan_buffer.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace vkpong
+{
+    class vulkan_device;
+} // namespace vkpong
+
+namespace vkpong
+{
+    // Collects buffer and image uploads through staging buffers and submits
+    // them as a single batch, on the transfer only queue when the device
+    // has one. Completion is signaled on a timeline semaphore which the
+    // submission using the uploads waits on.
+    class [[nodiscard]] upload_manager final
+    {
+    public: // Construction
+        explicit upload_manager(vulkan_device* device);
+
+        upload_manager(upload_manager const&) = delete;
+
+        upload_manager(upload_manager&&) noexcept = delete;
+
+    public: // Destruction
+        ~upload_manager();
+
+    public: // Interface
+        // Host visible buffers are written directly without staging.
+        void upload(vulkan_buffer& buffer,
+            VkDeviceSize offset,
+            std::span<std::byte const> bytes);
+
+        // Whole contents of a single mip level color image, the image is
+        // transitioned from an undefined layout to the given one.
+        void upload(VkImage image,
+            VkExtent2D extent,
+            VkImageLayout layout,
+            std::span<std::byte const> bytes);
+
+        // Submits uploads collected since the last submit. Returns the
+        // semaphore the submission using them has to wait on, empty when
+        // there was nothing to submit.
+        [[nodiscard]] std::optional<VkSemaphoreSubmitInfo> submit();
+
+        // Records acquisition of uploaded resources released by the
+        // transfer queue, into a graphics command buffer of the submission
+        // waiting on the uploads.
+        void record_acquire(VkCommandBuffer command_buffer);
+
+        // Waits for all submitted uploads to complete.
+        void wait();
+
+        [[nodiscard]] constexpr bool dedicated_queue() const noexcept;
+
+    public: // Operators
+        upload_manager& operator=(upload_manager const&) = delete;
+
+        upload_manager& operator=(upload_manager&&) noexcept = delete;
+
+    private: // Types
+        struct [[nodiscard]] submitted_batch final
+        {
+            uint64_t value{};
+            VkCommandBuffer command_buffer{};
+            std::vector<vulkan_buffer> staging;
+        };
+
+    private: // Helpers
+        [[nodiscard]] VkCommandBuffer recording_command_buffer();
+
+        [[nodiscard]] vulkan_buffer& stage(std::span<std::byte const> bytes);
+
+        void release_completed();
+
+    private: // Data
+        vulkan_device* device_;
+        bool dedicated_queue_;
+        VkQueue queue_{};
+        VkCommandPool command_pool_{};
+        VkSemaphore semaphore_{};
+        uint64_t value_{};
+
+        VkCommandBuffer command_buffer_{};
+        std::vector<vulkan_buffer> staging_;
+        std::vector<VkBufferMemoryBarrier2> buffer_acquires_;
+        std::vector<VkImageMemoryBarrier2> image_acquires_;
+        std::vector<submitted_batch> submitted_;
+    };
+} // namespace vkpong
+
+inline constexpr bool vkpong::upload_manager::dedicated_queue() const noexcept
+{
+    return dedicated_queue_;
+}
+
+#endif // !VKPONG_UPLOAD_MANAGER_INCLUDED
@@ -1,4 +1,11 @@
+#include <app_options.hpp>
+#include <benchmarks.hpp>
+#include <debug_panels.hpp>
+#include <diagnostics.hpp>
+#include <frame_capture.hpp>
+#include <frame_readback.hpp>
 #include <game.hpp>
+#include <headless_app.hpp>
 #include <imgui_impl_glfw.hpp>
 #include <imgui_impl_vulkan.hpp>
 #include <vulkan_context.hpp>
@@ -8,13 +15,15 @@
 #include <window.hpp>
 
 #include <GLFW/glfw3.h>
+#include <fmt/format.h>
+#include <imgui.h>
 #include <spdlog/spdlog.h>
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
-#include <functional>
 #include <memory>
-#include <utility>
 
 namespace
 {
@@ -24,6 +33,8 @@ namespace
     constexpr bool enable_validation_layers{true};
 #endif
 
+    constexpr std::chrono::seconds memory_log_interval{10};
+
     class [[nodiscard]] vkpong_app final
     {
     public: // Construction
@@ -64,9 +75,19 @@ namespace
                     ImGui_ImplVulkan_NewFrame();
                     ImGui_ImplGlfw_NewFrame();
                     ImGui::NewFrame();
-                    ImGui::ShowDemoWindow();
+                    vkpong::show_profiler(renderer_,
+                        device_.max_msaa_samples(),
+                        swap_chain_.extent());
+                    vkpong::show_memory(device_);
 
                     renderer_.draw(game_);
+
+                    if (auto const now{std::chrono::steady_clock::now()};
+                        now - last_memory_log_time_ > memory_log_interval)
+                    {
+                        vkpong::log_memory(device_);
+                        last_memory_log_time_ = now;
+                    }
                 });
         }
 
@@ -97,6 +118,15 @@ namespace
                     app->action(vkpong::action::up);
                 }
             }
+
+            if (action == GLFW_PRESS && key == GLFW_KEY_F12)
+            {
+                app->screenshot();
+            }
+            else if (action == GLFW_PRESS && key == GLFW_KEY_F9)
+            {
+                app->toggle_capture();
+            }
         }
 
         static void framebuffer_resize_callback(GLFWwindow* window,
@@ -113,6 +143,39 @@ namespace
 
         void action(vkpong::action act) { game_.update(act); }
 
+        void screenshot()
+        {
+            renderer_.readback().request(
+                [](vkpong::readback_image const& image)
+                {
+                    vkpong::save_screenshot(
+                        fmt::format("vkpong_{}.ppm", image.frame),
+                        image);
+                });
+        }
+
+        void toggle_capture()
+        {
+            vkpong::frame_readback& readback{renderer_.readback()};
+            if (capture_)
+            {
+                readback.set_continuous({});
+                capture_.reset();
+                spdlog::info("Capture stopped, readback skipped {} frames",
+                    readback.skipped_frames() - capture_skipped_frames_);
+                return;
+            }
+
+            capture_ = std::make_shared<vkpong::frame_capture>(
+                fmt::format("vkpong_{}.y4m", ++capture_count_),
+                swap_chain_.extent(),
+                vkpong::frame_capture::default_frame_rate);
+            capture_skipped_frames_ = readback.skipped_frames();
+            readback.set_continuous(
+                [capture = capture_](vkpong::readback_image const& image)
+                { capture->push(image); });
+        }
+
     private: // Data
         vkpong::game game_;
         vkpong::window window_;
@@ -121,17 +184,53 @@ namespace
         vkpong::vulkan_swap_chain swap_chain_;
         vkpong::vulkan_renderer renderer_;
 
+        std::shared_ptr<vkpong::frame_capture> capture_;
+        uint32_t capture_count_{};
+        uint64_t capture_skipped_frames_{};
+
         std::chrono::steady_clock::time_point last_tick_time_{
             std::chrono::steady_clock::now()};
+        std::chrono::steady_clock::time_point last_memory_log_time_{
+            std::chrono::steady_clock::now()};
     };
 } // namespace
 
-int main()
+int main(int argc, char** argv)
 {
     try
     {
-        vkpong_app app{vkpong::window::default_width,
-            vkpong::window::default_height};
+        vkpong::app_options const opts{
+            vkpong::parse_options({argv, static_cast<size_t>(argc)})};
+        if (opts.headless)
+        {
+            vkpong::headless_app app{opts.width,
+                opts.height,
+                enable_validation_layers};
+            if (opts.benchmark_quality)
+            {
+                vkpong::benchmark_quality(app, opts.frames);
+            }
+            else if (opts.benchmark_instances)
+            {
+                vkpong::benchmark_instances(app, opts.frames);
+            }
+            else if (opts.benchmark_shader_objects)
+            {
+                vkpong::benchmark_shader_objects(app, opts.frames);
+            }
+            else if (opts.validate_particles)
+            {
+                return vkpong::validate_particles(app, opts.frames) ? 0 : 1;
+            }
+            else
+            {
+                app.run(opts);
+            }
+            return 0;
+        }
+
+        vkpong_app app{static_cast<int>(opts.width),
+            static_cast<int>(opts.height)};
         app.run();
     }
     catch (std::exception const& ex)
@@ -1,21 +1,35 @@
 #include <vulkan_buffer.hpp>
 
+#include <device_allocator.hpp>
+#include <host_allocator.hpp>
 #include <vulkan_device.hpp>
-#include <vulkan_utility.hpp>
 
 #include <cassert>
 #include <cstring>
 #include <stdexcept>
 #include <utility>
 
+namespace
+{
+    // Buffers used only as a copy source or destination are staging.
+    [[nodiscard]] vkpong::allocation_category buffer_category(
+        VkBufferUsageFlags const usage)
+    {
+        constexpr VkBufferUsageFlags transfer{
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT};
+
+        return (usage & ~transfer) == 0 ? vkpong::allocation_category::staging
+                                        : vkpong::allocation_category::buffer;
+    }
+} // namespace
+
 vkpong::vulkan_buffer::vulkan_buffer(vulkan_device* device,
     VkDeviceSize size,
     VkBufferCreateFlags usage,
-    VkMemoryPropertyFlags memory_properties,
-    bool keep_mapped)
+    memory_preference const& memory)
     : device_{device}
     , size_{size}
-    , keep_mapped_{keep_mapped}
 {
     VkBufferCreateInfo buffer_info{};
     buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -23,8 +37,10 @@ vkpong::vulkan_buffer::vulkan_buffer(vulkan_device* device,
     buffer_info.usage = usage;
     buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    if (vkCreateBuffer(device_->logical(), &buffer_info, nullptr, &buffer_) !=
-        VK_SUCCESS)
+    if (vkCreateBuffer(device_->logical(),
+            &buffer_info,
+            allocation_callbacks(),
+            &buffer_) != VK_SUCCESS)
     {
         throw std::runtime_error{"failed to create buffer!"};
     }
@@ -34,30 +50,27 @@ vkpong::vulkan_buffer::vulkan_buffer(vulkan_device* device,
         buffer_,
         &memory_requirements);
 
-    VkMemoryAllocateInfo alloc_info{};
-    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    alloc_info.allocationSize = memory_requirements.size;
-    alloc_info.memoryTypeIndex = find_memory_type(device_->physical(),
-        memory_requirements.memoryTypeBits,
-        memory_properties);
-
-    if (vkAllocateMemory(device_->logical(),
-            &alloc_info,
-            nullptr,
-            &device_memory_) != VK_SUCCESS)
+    try
     {
-        throw std::runtime_error{"failed to allocate buffer memory!"};
+        allocation_ = device_->allocator().allocate(memory_requirements,
+            memory,
+            allocation_tiling::linear,
+            buffer_category(usage));
     }
-
-    if (vkBindBufferMemory(device_->logical(), buffer_, device_memory_, 0) !=
-        VK_SUCCESS)
+    catch (...)
     {
-        throw std::runtime_error{"failed to bind buffer memory!"};
+        vkDestroyBuffer(device_->logical(), buffer_, allocation_callbacks());
+        throw;
     }
 
-    if (keep_mapped_)
+    if (vkBindBufferMemory(device_->logical(),
+            buffer_,
+            allocation_.memory,
+            allocation_.offset) != VK_SUCCESS)
     {
-        map_memory(0, size_);
+        vkDestroyBuffer(device_->logical(), buffer_, allocation_callbacks());
+        device_->allocator().free(allocation_);
+        throw std::runtime_error{"failed to bind buffer memory!"};
     }
 }
 
@@ -65,9 +78,7 @@ vkpong::vulkan_buffer::vulkan_buffer(vulkan_buffer&& other) noexcept
     : device_{std::exchange(other.device_, nullptr)}
     , size_{std::exchange(other.size_, {})}
     , buffer_{std::exchange(other.buffer_, nullptr)}
-    , device_memory_{std::exchange(other.device_memory_, nullptr)}
-    , keep_mapped_{std::exchange(other.keep_mapped_, {})}
-    , memory_mapping_{std::exchange(other.memory_mapping_, {})}
+    , allocation_{std::exchange(other.allocation_, {})}
 {
 }
 
@@ -75,34 +86,46 @@ vkpong::vulkan_buffer::~vulkan_buffer()
 {
     if (device_)
     {
-        if (memory_mapping_)
-        {
-            unmap_memory();
-        }
-
-        vkDestroyBuffer(device_->logical(), buffer_, nullptr);
-        vkFreeMemory(device_->logical(), device_memory_, nullptr);
+        vkDestroyBuffer(device_->logical(), buffer_, allocation_callbacks());
+        device_->allocator().free(allocation_);
     }
 }
 
 void vkpong::vulkan_buffer::fill(size_t const offset,
     std::span<std::byte const> bytes)
 {
-    size_t offset_in_mapping{offset};
-    if (!keep_mapped_)
-    {
-        map_memory(offset, bytes.size());
-        offset_in_mapping = 0;
-    }
+    assert(allocation_.mapped);
+    assert(offset + bytes.size() <= size_);
 
-    memcpy(reinterpret_cast<std::byte*>(memory_mapping_) + offset_in_mapping,
-        bytes.data(),
-        bytes.size());
+    memcpy(allocation_.mapped + offset, bytes.data(), bytes.size());
+    mark_written(offset, bytes.size());
+}
 
-    if (!keep_mapped_)
-    {
-        unmap_memory();
-    }
+void vkpong::vulkan_buffer::mark_written(VkDeviceSize const offset,
+    VkDeviceSize const size)
+{
+    device_->allocator().flush(allocation_, offset, size);
+}
+
+void vkpong::vulkan_buffer::invalidate(VkDeviceSize const offset,
+    VkDeviceSize const size) const
+{
+    device_->allocator().invalidate(allocation_, offset, size);
+}
+
+std::span<std::byte> vkpong::vulkan_buffer::mapped_bytes() noexcept
+{
+    assert(allocation_.mapped);
+
+    return {allocation_.mapped, size_};
+}
+
+std::span<std::byte const>
+vkpong::vulkan_buffer::mapped_bytes() const noexcept
+{
+    assert(allocation_.mapped);
+
+    return {allocation_.mapped, size_};
 }
 
 vkpong::vulkan_buffer& vkpong::vulkan_buffer::operator=(
@@ -115,31 +138,8 @@ vkpong::vulkan_buffer& vkpong::vulkan_buffer::operator=(
         swap(device_, other.device_);
         swap(size_, other.size_);
         swap(buffer_, other.buffer_);
-        swap(device_memory_, other.device_memory_);
-        swap(keep_mapped_, other.keep_mapped_);
-        swap(memory_mapping_, other.memory_mapping_);
+        swap(allocation_, other.allocation_);
     }
 
     return *this;
 }
-
-void vkpong::vulkan_buffer::map_memory(size_t const offset, size_t const size)
-{
-    assert(size + offset <= size_);
-
-    if (vkMapMemory(device_->logical(),
-            device_memory_,
-            offset,
-            size,
-            0,
-            &memory_mapping_) != VK_SUCCESS)
-    {
-        throw std::runtime_error{"unable to map memory!"};
-    }
-}
-
-void vkpong::vulkan_buffer::unmap_memory()
-{
-    vkUnmapMemory(device_->logical(), device_memory_);
-    memory_mapping_ = nullptr;
-}
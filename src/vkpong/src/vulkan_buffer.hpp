@@ -1,6 +1,8 @@
 #ifndef VKPONG_VULKAN_BUFFER_INCLUDED
 #define VKPONG_VULKAN_BUFFER_INCLUDED
 
+#include <device_allocator.hpp>
+
 #include <vulkan/vulkan_core.h>
 
 #include <cstddef>
@@ -8,19 +10,21 @@
 
 namespace vkpong
 {
+    struct memory_preference;
     class vulkan_device;
 } // namespace vkpong
 
 namespace vkpong
 {
+    // Memory comes from the device allocator, host visible buffers are
+    // always mapped.
     class [[nodiscard]] vulkan_buffer final
     {
     public: // Construction
         vulkan_buffer(vulkan_device* device,
             VkDeviceSize size,
             VkBufferCreateFlags usage,
-            VkMemoryPropertyFlags memory_properties,
-            bool keep_mapped = false);
+            memory_preference const& memory);
 
         vulkan_buffer(vulkan_buffer const&) = delete;
 
@@ -32,24 +36,34 @@ namespace vkpong
     public: // Interface
         [[nodiscard]] constexpr VkBuffer buffer() const noexcept;
 
+        [[nodiscard]] constexpr VkDeviceSize size() const noexcept;
+
+        [[nodiscard]] constexpr bool host_visible() const noexcept;
+
+        // Copies into the mapping and marks the range as written.
         void fill(size_t offset, std::span<std::byte const> bytes);
 
+        // Marks a range written through mapped_bytes, non coherent memory
+        // is flushed with the next batched flush of the allocator.
+        void mark_written(VkDeviceSize offset, VkDeviceSize size);
+
+        // Must precede reading device writes through mapped_bytes.
+        void invalidate(VkDeviceSize offset, VkDeviceSize size) const;
+
+        [[nodiscard]] std::span<std::byte> mapped_bytes() noexcept;
+
+        [[nodiscard]] std::span<std::byte const> mapped_bytes() const noexcept;
+
     public: // Operators
         vulkan_buffer& operator=(vulkan_buffer const&) = delete;
 
         vulkan_buffer& operator=(vulkan_buffer&& other) noexcept;
 
-    private: // Helpers
-        void map_memory(size_t offset, size_t size);
-        void unmap_memory();
-
     private: // Data
         vulkan_device* device_;
         VkDeviceSize size_{};
         VkBuffer buffer_{};
-        VkDeviceMemory device_memory_{};
-        bool keep_mapped_{};
-        void* memory_mapping_{};
+        device_allocation allocation_;
     };
 } // namespace vkpong
 
@@ -58,4 +72,14 @@ inline constexpr VkBuffer vkpong::vulkan_buffer::buffer() const noexcept
     return buffer_;
 }
 
+inline constexpr VkDeviceSize vkpong::vulkan_buffer::size() const noexcept
+{
+    return size_;
+}
+
+inline constexpr bool vkpong::vulkan_buffer::host_visible() const noexcept
+{
+    return allocation_.mapped != nullptr;
+}
+
 #endif // !VKPONG_VULKAN_BUFFER_INCLUDED
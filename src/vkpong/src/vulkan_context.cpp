@@ -1,5 +1,6 @@
 #include <vulkan_context.hpp>
 
+#include <host_allocator.hpp>
 #include <vulkan_utility.hpp>
 
 #include <GLFW/glfw3.h>
@@ -123,7 +124,7 @@ namespace
 
         return create_debug_utils_messenger_ext(instance,
             &create_info,
-            nullptr,
+            vkpong::allocation_callbacks(),
             &debug_messenger);
     }
 } // namespace
@@ -148,17 +149,17 @@ vkpong::vulkan_context::~vulkan_context()
 {
     if (surface_)
     {
-        vkDestroySurfaceKHR(instance_, surface_, nullptr);
+        vkDestroySurfaceKHR(instance_, surface_, allocation_callbacks());
     }
 
     if (debug_messenger_)
     {
         destroy_debug_utils_messenger_ext(instance_,
             *debug_messenger_,
-            nullptr);
+            allocation_callbacks());
     }
 
-    vkDestroyInstance(instance_, nullptr);
+    vkDestroyInstance(instance_, allocation_callbacks());
 }
 
 vkpong::vulkan_context& vkpong::vulkan_context::operator=(
@@ -189,12 +190,16 @@ vkpong::vulkan_context vkpong::create_context(GLFWwindow* const window,
     create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
     create_info.pApplicationInfo = &app_info;
 
-    uint32_t glfw_extension_count{};
-    char const** const glfw_extensions{
-        glfwGetRequiredInstanceExtensions(&glfw_extension_count)};
+    std::vector<char const*> required_extensions;
+    if (window)
+    {
+        uint32_t glfw_extension_count{};
+        char const** const glfw_extensions{
+            glfwGetRequiredInstanceExtensions(&glfw_extension_count)};
 
-    std::vector<char const*> required_extensions{glfw_extensions,
-        glfw_extensions + glfw_extension_count};
+        required_extensions.assign(glfw_extensions,
+            glfw_extensions + glfw_extension_count);
+    }
 
     bool has_debug_utils_extension{setup_validation_layers};
     VkDebugUtilsMessengerCreateInfoEXT debug_create_info;
@@ -221,7 +226,9 @@ vkpong::vulkan_context vkpong::create_context(GLFWwindow* const window,
     create_info.ppEnabledExtensionNames = required_extensions.data();
 
     VkInstance instance{};
-    if (vkCreateInstance(&create_info, nullptr, &instance) != VK_SUCCESS)
+    if (vkCreateInstance(&create_info,
+            allocation_callbacks(),
+            &instance) != VK_SUCCESS)
     {
         throw std::runtime_error{"failed to create instance"};
     }
@@ -232,23 +239,26 @@ vkpong::vulkan_context vkpong::create_context(GLFWwindow* const window,
         VkDebugUtilsMessengerEXT messenger{};
         if (create_debug_messenger(instance, messenger) != VK_SUCCESS)
         {
-            vkDestroyInstance(instance, nullptr);
+            vkDestroyInstance(instance, allocation_callbacks());
             throw std::runtime_error{"failed to create debug messenger!"};
         }
         debug_messenger = messenger;
     }
 
     VkSurfaceKHR surface{};
-    if (glfwCreateWindowSurface(instance, window, nullptr, &surface) !=
-        VK_SUCCESS)
+    if (window &&
+        glfwCreateWindowSurface(instance,
+            window,
+            allocation_callbacks(),
+            &surface) != VK_SUCCESS)
     {
         if (debug_messenger)
         {
             destroy_debug_utils_messenger_ext(instance,
                 *debug_messenger,
-                nullptr);
+                allocation_callbacks());
         }
-        vkDestroyInstance(instance, nullptr);
+        vkDestroyInstance(instance, allocation_callbacks());
         throw std::runtime_error{"failed to create window surface"};
     }
 
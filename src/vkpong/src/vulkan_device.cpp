@@ -1,5 +1,7 @@
 #include <vulkan_device.hpp>
 
+#include <device_allocator.hpp>
+#include <host_allocator.hpp>
 #include <vulkan_context.hpp>
 #include <vulkan_swap_chain.hpp>
 #include <vulkan_utility.hpp>
@@ -9,6 +11,7 @@
 #include <optional>
 #include <ranges>
 #include <set>
+#include <span>
 #include <stdexcept>
 #include <string_view>
 #include <utility>
@@ -20,15 +23,39 @@ namespace
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
         VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME};
 
+    constexpr std::array const headless_device_extensions = {
+        VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME};
+
+    [[nodiscard]] std::span<char const* const> required_extensions(
+        VkSurfaceKHR surface)
+    {
+        if (surface)
+        {
+            return device_extensions;
+        }
+
+        return headless_device_extensions;
+    }
+
     constexpr VkPhysicalDeviceFeatures device_features{
         .sampleRateShading = VK_TRUE,
         .samplerAnisotropy = VK_TRUE};
 
+    constexpr VkPhysicalDeviceVulkan12Features device_12_features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .timelineSemaphore = VK_TRUE};
+
     constexpr VkPhysicalDeviceVulkan13Features device_13_features{
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
         .synchronization2 = VK_TRUE,
         .dynamicRendering = VK_TRUE};
 
+    constexpr VkStructureType dynamic_state_3_features_type =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+
+    constexpr VkStructureType shader_object_features_type =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT;
+
     struct [[nodiscard]] queue_family_indices final
     {
         std::optional<uint32_t> graphics_family;
@@ -57,10 +84,19 @@ namespace
             }
 
             VkBool32 present_support{VK_FALSE};
-            vkGetPhysicalDeviceSurfaceSupportKHR(device,
-                i,
-                surface,
-                &present_support);
+            if (surface)
+            {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device,
+                    i,
+                    surface,
+                    &present_support);
+            }
+            else
+            {
+                // Nothing is presented without a surface, the graphics queue
+                // stands in for the present queue.
+                present_support = indices.graphics_family == i;
+            }
 
             if (present_support)
             {
@@ -78,33 +114,121 @@ namespace
         return indices;
     }
 
-    [[nodiscard]] bool extensions_supported(VkPhysicalDevice device)
+    // Transfer only families are usually backed by dedicated copy engines.
+    [[nodiscard]] std::optional<uint32_t> find_transfer_family(
+        VkPhysicalDevice device)
+    {
+        uint32_t count{};
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &count, nullptr);
+
+        std::vector<VkQueueFamilyProperties> queue_families{count};
+        vkGetPhysicalDeviceQueueFamilyProperties(device,
+            &count,
+            queue_families.data());
+
+        for (uint32_t i{}; i != count; ++i)
+        {
+            VkQueueFlags const flags{queue_families[i].queueFlags};
+            if ((flags & VK_QUEUE_TRANSFER_BIT) &&
+                !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+            {
+                return i;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    [[nodiscard]] std::vector<VkExtensionProperties> available_extensions(
+        VkPhysicalDevice device)
     {
         uint32_t count{};
         vkEnumerateDeviceExtensionProperties(device, nullptr, &count, nullptr);
 
-        std::vector<VkExtensionProperties> available_extensions{count};
+        std::vector<VkExtensionProperties> rv{count};
         vkEnumerateDeviceExtensionProperties(device,
             nullptr,
             &count,
-            available_extensions.data());
+            rv.data());
 
-        std::set<std::string_view> required_extensions(
-            device_extensions.cbegin(),
-            device_extensions.cend());
-        for (auto const& extension : available_extensions)
+        return rv;
+    }
+
+    [[nodiscard]] bool extensions_supported(VkPhysicalDevice device,
+        VkSurfaceKHR surface)
+    {
+        auto const extensions{required_extensions(surface)};
+        std::set<std::string_view> missing_extensions(extensions.begin(),
+            extensions.end());
+        for (auto const& extension : available_extensions(device))
         {
-            required_extensions.erase(extension.extensionName);
+            missing_extensions.erase(extension.extensionName);
         }
 
-        return required_extensions.empty();
+        return missing_extensions.empty();
+    }
+
+    [[nodiscard]] bool has_extension(VkPhysicalDevice device,
+        std::string_view const name)
+    {
+        return std::ranges::any_of(available_extensions(device),
+            [name](VkExtensionProperties const& extension)
+            { return std::string_view{extension.extensionName} == name; });
+    }
+
+    // Rasterization samples and color blending can be set while recording
+    // when the device supports extended dynamic state 3.
+    [[nodiscard]] VkPhysicalDeviceExtendedDynamicState3FeaturesEXT
+    query_extended_dynamic_state(VkPhysicalDevice device)
+    {
+        VkPhysicalDeviceExtendedDynamicState3FeaturesEXT rv{};
+        rv.sType = dynamic_state_3_features_type;
+
+        if (!has_extension(device,
+                VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME))
+        {
+            return rv;
+        }
+
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &rv;
+        vkGetPhysicalDeviceFeatures2(device, &features);
+        rv.pNext = nullptr;
+
+        return rv;
+    }
+
+    [[nodiscard]] bool supports_shader_objects(VkPhysicalDevice device)
+    {
+        if (!has_extension(device, VK_EXT_SHADER_OBJECT_EXTENSION_NAME))
+        {
+            return false;
+        }
+
+        VkPhysicalDeviceShaderObjectFeaturesEXT shader_object{};
+        shader_object.sType = shader_object_features_type;
+
+        VkPhysicalDeviceFeatures2 features{};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &shader_object;
+        vkGetPhysicalDeviceFeatures2(device, &features);
+
+        return shader_object.shaderObject == VK_TRUE;
+    }
+
+    template<typename T>
+    [[nodiscard]] T load_device_function(VkDevice device, char const* name)
+    {
+        // NOLINTNEXTLINE
+        return reinterpret_cast<T>(vkGetDeviceProcAddr(device, name));
     }
 
     [[nodiscard]] bool is_device_suitable(VkPhysicalDevice device,
         VkSurfaceKHR surface,
         queue_family_indices& indices)
     {
-        if (!extensions_supported(device))
+        if (!extensions_supported(device, surface))
         {
             return false;
         }
@@ -117,12 +241,16 @@ namespace
             return false;
         }
 
-        auto swap_chain{vkpong::query_swap_chain_support(device, surface)};
-        bool const swap_chain_adequate = {!swap_chain.surface_formats.empty() &&
-            !swap_chain.present_modes.empty()};
-        if (!swap_chain_adequate)
+        if (surface)
         {
-            return false;
+            auto swap_chain{vkpong::query_swap_chain_support(device, surface)};
+            bool const swap_chain_adequate = {
+                !swap_chain.surface_formats.empty() &&
+                !swap_chain.present_modes.empty()};
+            if (!swap_chain_adequate)
+            {
+                return false;
+            }
         }
 
         VkPhysicalDeviceFeatures supported_features{};
@@ -162,18 +290,56 @@ namespace
         }
         return VK_SAMPLE_COUNT_1_BIT;
     }
+
+    [[nodiscard]] bool supports_pipeline_statistics(VkPhysicalDevice device)
+    {
+        VkPhysicalDeviceFeatures features{};
+        vkGetPhysicalDeviceFeatures(device, &features);
+        return features.pipelineStatisticsQuery == VK_TRUE;
+    }
+
+    [[nodiscard]] VkDeviceSize non_coherent_atom_size(
+        VkPhysicalDevice const device)
+    {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(device, &properties);
+        return properties.limits.nonCoherentAtomSize;
+    }
+
+    [[nodiscard]] VkPhysicalDeviceMemoryProperties query_memory_properties(
+        VkPhysicalDevice const device)
+    {
+        VkPhysicalDeviceMemoryProperties rv{};
+        vkGetPhysicalDeviceMemoryProperties(device, &rv);
+        return rv;
+    }
 } // namespace
 
 vkpong::vulkan_device::vulkan_device(VkPhysicalDevice physical_device,
     VkDevice logical_device,
     uint32_t graphics_family,
-    uint32_t present_family)
+    uint32_t present_family,
+    uint32_t transfer_family,
+    extended_dynamic_state const& dynamic_state,
+    shader_object_commands const& shader_objects,
+    bool const memory_budget)
     : physical_device_{physical_device}
     , logical_device_{logical_device}
     , graphics_family_{graphics_family}
     , present_family_{present_family}
+    , transfer_family_{transfer_family}
     , max_msaa_samples_{max_usable_sample_count(physical_device)}
+    , pipeline_statistics_supported_{
+          supports_pipeline_statistics(physical_device)}
+    , dynamic_state_{dynamic_state}
+    , shader_objects_{shader_objects}
+    , memory_properties_{query_memory_properties(physical_device)}
+    , memory_budget_supported_{memory_budget}
+    , allocator_{std::make_unique<device_allocator>(logical_device,
+          memory_properties_,
+          non_coherent_atom_size(physical_device))}
 {
+    poll_memory_budget();
 }
 
 vkpong::vulkan_device::vulkan_device(vulkan_device&& other) noexcept
@@ -181,13 +347,69 @@ vkpong::vulkan_device::vulkan_device(vulkan_device&& other) noexcept
     , logical_device_{std::exchange(other.logical_device_, nullptr)}
     , graphics_family_{other.graphics_family_}
     , present_family_{other.present_family_}
+    , transfer_family_{other.transfer_family_}
     , max_msaa_samples_{other.max_msaa_samples_}
+    , pipeline_statistics_supported_{other.pipeline_statistics_supported_}
+    , dynamic_state_{other.dynamic_state_}
+    , shader_objects_{other.shader_objects_}
+    , memory_properties_{other.memory_properties_}
+    , memory_budget_supported_{other.memory_budget_supported_}
+    , memory_budget_{other.memory_budget_}
+    , allocator_{std::move(other.allocator_)}
 {
 }
 
 vkpong::vulkan_device::~vulkan_device()
 {
-    vkDestroyDevice(logical_device_, nullptr);
+    allocator_.reset();
+    vkDestroyDevice(logical_device_, allocation_callbacks());
+}
+
+void vkpong::vulkan_device::poll_memory_budget()
+{
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget{};
+    budget.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    if (memory_budget_supported_)
+    {
+        VkPhysicalDeviceMemoryProperties2 properties{};
+        properties.sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        properties.pNext = &budget;
+        vkGetPhysicalDeviceMemoryProperties2(physical_device_, &properties);
+    }
+
+    device_allocator_statistics const& statistics{allocator_->statistics()};
+    for (uint32_t i{}; i != memory_properties_.memoryHeapCount; ++i)
+    {
+        VkMemoryHeap const& heap{memory_properties_.memoryHeaps[i]};
+
+        heap_budget& current{memory_budget_[i]};
+        current.size = heap.size;
+        current.device_local =
+            (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        if (memory_budget_supported_)
+        {
+            current.budget = budget.heapBudget[i];
+            current.usage = budget.heapUsage[i];
+        }
+        else
+        {
+            current.budget = heap.size;
+            current.usage = statistics.heap_reserved_bytes[i];
+        }
+    }
+}
+
+vkpong::device_allocator& vkpong::vulkan_device::allocator() noexcept
+{
+    return *allocator_;
+}
+
+vkpong::device_allocator const&
+vkpong::vulkan_device::allocator() const noexcept
+{
+    return *allocator_;
 }
 
 vkpong::vulkan_device& vkpong::vulkan_device::operator=(
@@ -201,7 +423,16 @@ vkpong::vulkan_device& vkpong::vulkan_device::operator=(
         swap(logical_device_, other.logical_device_);
         swap(graphics_family_, other.graphics_family_);
         swap(present_family_, other.present_family_);
+        swap(transfer_family_, other.transfer_family_);
         swap(max_msaa_samples_, other.max_msaa_samples_);
+        swap(pipeline_statistics_supported_,
+            other.pipeline_statistics_supported_);
+        swap(dynamic_state_, other.dynamic_state_);
+        swap(shader_objects_, other.shader_objects_);
+        swap(memory_properties_, other.memory_properties_);
+        swap(memory_budget_supported_, other.memory_budget_supported_);
+        swap(memory_budget_, other.memory_budget_);
+        swap(allocator_, other.allocator_);
     }
 
     return *this;
@@ -233,9 +464,13 @@ vkpong::vulkan_device vkpong::create_device(vulkan_context const& context)
 
     auto const graphics_family{device_indices.graphics_family.value_or(0)};
     auto const present_family{device_indices.present_family.value_or(0)};
+    auto const transfer_family{
+        find_transfer_family(*device_it).value_or(graphics_family)};
 
     float const priority{1.0f};
-    std::set<uint32_t> const unique_families{graphics_family, present_family};
+    std::set<uint32_t> const unique_families{graphics_family,
+        present_family,
+        transfer_family};
     std::vector<VkDeviceQueueCreateInfo> queue_create_infos;
     for (uint32_t const family : unique_families)
     {
@@ -253,17 +488,129 @@ vkpong::vulkan_device vkpong::create_device(vulkan_context const& context)
     create_info.queueCreateInfoCount = count_cast(queue_create_infos.size());
     create_info.pQueueCreateInfos = queue_create_infos.data();
     create_info.enabledLayerCount = 0;
-    create_info.enabledExtensionCount = count_cast(device_extensions.size());
-    create_info.ppEnabledExtensionNames = device_extensions.data();
-    create_info.pEnabledFeatures = &device_features;
-    create_info.pNext = &device_13_features;
+    auto const required{required_extensions(context.surface())};
+    std::vector<char const*> extensions{required.begin(), required.end()};
+
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT const
+        supported_dynamic_state{query_extended_dynamic_state(*device_it)};
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT dynamic_state_features{};
+    dynamic_state_features.sType = dynamic_state_3_features_type;
+    dynamic_state_features.extendedDynamicState3RasterizationSamples =
+        supported_dynamic_state.extendedDynamicState3RasterizationSamples;
+    // Blending is dynamic only when both the enable and the equation are.
+    bool const dynamic_blending{
+        supported_dynamic_state.extendedDynamicState3ColorBlendEnable &&
+        supported_dynamic_state.extendedDynamicState3ColorBlendEquation};
+    dynamic_state_features.extendedDynamicState3ColorBlendEnable =
+        dynamic_blending ? VK_TRUE : VK_FALSE;
+    dynamic_state_features.extendedDynamicState3ColorBlendEquation =
+        dynamic_blending ? VK_TRUE : VK_FALSE;
+    bool const any_dynamic_state{
+        dynamic_state_features.extendedDynamicState3RasterizationSamples ||
+        dynamic_blending};
+    if (any_dynamic_state)
+    {
+        extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+    }
+
+    bool const shader_objects{supports_shader_objects(*device_it)};
+    VkPhysicalDeviceShaderObjectFeaturesEXT shader_object_features{};
+    shader_object_features.sType = shader_object_features_type;
+    shader_object_features.shaderObject = VK_TRUE;
+    if (shader_objects)
+    {
+        extensions.push_back(VK_EXT_SHADER_OBJECT_EXTENSION_NAME);
+    }
+
+    bool const memory_budget{
+        has_extension(*device_it, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)};
+    if (memory_budget)
+    {
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    create_info.enabledExtensionCount = count_cast(extensions.size());
+    create_info.ppEnabledExtensionNames = extensions.data();
+    VkPhysicalDeviceFeatures features{device_features};
+    if (supports_pipeline_statistics(*device_it))
+    {
+        features.pipelineStatisticsQuery = VK_TRUE;
+    }
+    create_info.pEnabledFeatures = &features;
+
+    VkPhysicalDeviceVulkan12Features features_12{device_12_features};
+    VkPhysicalDeviceVulkan13Features features_13{device_13_features};
+    features_13.pNext = &features_12;
+    if (any_dynamic_state)
+    {
+        dynamic_state_features.pNext = features_12.pNext;
+        features_12.pNext = &dynamic_state_features;
+    }
+    if (shader_objects)
+    {
+        shader_object_features.pNext = features_12.pNext;
+        features_12.pNext = &shader_object_features;
+    }
+    create_info.pNext = &features_13;
 
     VkDevice logical_device{};
-    if (vkCreateDevice(*device_it, &create_info, nullptr, &logical_device) !=
-        VK_SUCCESS)
+    if (vkCreateDevice(*device_it,
+            &create_info,
+            allocation_callbacks(),
+            &logical_device) != VK_SUCCESS)
     {
         throw std::runtime_error{"failed to create logical device!"};
     }
 
-    return {*device_it, logical_device, graphics_family, present_family};
+    vkpong::extended_dynamic_state dynamic_state;
+    if (dynamic_state_features.extendedDynamicState3RasterizationSamples)
+    {
+        dynamic_state.set_rasterization_samples =
+            load_device_function<PFN_vkCmdSetRasterizationSamplesEXT>(
+                logical_device,
+                "vkCmdSetRasterizationSamplesEXT");
+    }
+    if (dynamic_blending)
+    {
+        dynamic_state.set_color_blend_enable =
+            load_device_function<PFN_vkCmdSetColorBlendEnableEXT>(
+                logical_device,
+                "vkCmdSetColorBlendEnableEXT");
+        dynamic_state.set_color_blend_equation =
+            load_device_function<PFN_vkCmdSetColorBlendEquationEXT>(
+                logical_device,
+                "vkCmdSetColorBlendEquationEXT");
+    }
+
+    vkpong::shader_object_commands commands;
+    if (shader_objects)
+    {
+        auto const load = [logical_device]<typename T>(T& function,
+                              char const* const name)
+        { function = load_device_function<T>(logical_device, name); };
+
+        load(commands.create_shaders, "vkCreateShadersEXT");
+        load(commands.destroy_shader, "vkDestroyShaderEXT");
+        load(commands.bind_shaders, "vkCmdBindShadersEXT");
+        load(commands.set_vertex_input, "vkCmdSetVertexInputEXT");
+        load(commands.set_polygon_mode, "vkCmdSetPolygonModeEXT");
+        load(commands.set_rasterization_samples,
+            "vkCmdSetRasterizationSamplesEXT");
+        load(commands.set_sample_mask, "vkCmdSetSampleMaskEXT");
+        load(commands.set_alpha_to_coverage_enable,
+            "vkCmdSetAlphaToCoverageEnableEXT");
+        load(commands.set_color_blend_enable, "vkCmdSetColorBlendEnableEXT");
+        load(commands.set_color_blend_equation,
+            "vkCmdSetColorBlendEquationEXT");
+        load(commands.set_color_write_mask, "vkCmdSetColorWriteMaskEXT");
+    }
+
+    return {*device_it,
+        logical_device,
+        graphics_family,
+        present_family,
+        transfer_family,
+        dynamic_state,
+        commands,
+        memory_budget};
 }
@@ -3,22 +3,67 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <array>
 #include <cstdint>
+#include <memory>
+#include <span>
 
 namespace vkpong
 {
+    class device_allocator;
     class vulkan_context;
 } // namespace vkpong
 
 namespace vkpong
 {
+    // Commands of VK_EXT_extended_dynamic_state3, null when the device
+    // doesn't support the state and pipelines bake it instead.
+    struct [[nodiscard]] extended_dynamic_state final
+    {
+        PFN_vkCmdSetRasterizationSamplesEXT set_rasterization_samples{};
+        PFN_vkCmdSetColorBlendEnableEXT set_color_blend_enable{};
+        PFN_vkCmdSetColorBlendEquationEXT set_color_blend_equation{};
+    };
+
+    // Commands of VK_EXT_shader_object, null when the device doesn't
+    // support shader objects.
+    struct [[nodiscard]] shader_object_commands final
+    {
+        PFN_vkCreateShadersEXT create_shaders{};
+        PFN_vkDestroyShaderEXT destroy_shader{};
+        PFN_vkCmdBindShadersEXT bind_shaders{};
+        PFN_vkCmdSetVertexInputEXT set_vertex_input{};
+        PFN_vkCmdSetPolygonModeEXT set_polygon_mode{};
+        PFN_vkCmdSetRasterizationSamplesEXT set_rasterization_samples{};
+        PFN_vkCmdSetSampleMaskEXT set_sample_mask{};
+        PFN_vkCmdSetAlphaToCoverageEnableEXT set_alpha_to_coverage_enable{};
+        PFN_vkCmdSetColorBlendEnableEXT set_color_blend_enable{};
+        PFN_vkCmdSetColorBlendEquationEXT set_color_blend_equation{};
+        PFN_vkCmdSetColorWriteMaskEXT set_color_write_mask{};
+    };
+
+    // Budget and usage of the whole process as reported by
+    // VK_EXT_memory_budget. Without the extension the budget is the heap
+    // size and usage covers only the device allocator.
+    struct [[nodiscard]] heap_budget final
+    {
+        VkDeviceSize size{};
+        VkDeviceSize budget{};
+        VkDeviceSize usage{};
+        bool device_local{};
+    };
+
     class [[nodiscard]] vulkan_device final
     {
     public: // Construction
         vulkan_device(VkPhysicalDevice physical_device,
             VkDevice logical_device,
             uint32_t graphics_family,
-            uint32_t present_family);
+            uint32_t present_family,
+            uint32_t transfer_family,
+            extended_dynamic_state const& dynamic_state = {},
+            shader_object_commands const& shader_objects = {},
+            bool memory_budget = false);
 
         vulkan_device(vulkan_device const&) = delete;
 
@@ -36,9 +81,39 @@ namespace vkpong
 
         [[nodiscard]] constexpr uint32_t present_family() const noexcept;
 
+        // Transfer only queue family when the device has one, the graphics
+        // family otherwise.
+        [[nodiscard]] constexpr uint32_t transfer_family() const noexcept;
+
         [[nodiscard]] constexpr VkSampleCountFlagBits
         max_msaa_samples() const noexcept;
 
+        [[nodiscard]] constexpr bool
+        pipeline_statistics_supported() const noexcept;
+
+        [[nodiscard]] constexpr extended_dynamic_state const&
+        dynamic_state() const noexcept;
+
+        [[nodiscard]] constexpr shader_object_commands const&
+        shader_objects() const noexcept;
+
+        [[nodiscard]] constexpr bool shader_objects_supported() const noexcept;
+
+        [[nodiscard]] constexpr VkPhysicalDeviceMemoryProperties const&
+        memory_properties() const noexcept;
+
+        [[nodiscard]] constexpr bool memory_budget_supported() const noexcept;
+
+        // Queries current heap budgets, called once per frame.
+        void poll_memory_budget();
+
+        [[nodiscard]] constexpr std::span<heap_budget const>
+        memory_budget() const noexcept;
+
+        [[nodiscard]] device_allocator& allocator() noexcept;
+
+        [[nodiscard]] device_allocator const& allocator() const noexcept;
+
     public: // Operators
         vulkan_device& operator=(vulkan_device const&) = delete;
 
@@ -49,7 +124,15 @@ namespace vkpong
         VkDevice logical_device_{};
         uint32_t graphics_family_{};
         uint32_t present_family_{};
+        uint32_t transfer_family_{};
         VkSampleCountFlagBits max_msaa_samples_{VK_SAMPLE_COUNT_1_BIT};
+        bool pipeline_statistics_supported_{};
+        extended_dynamic_state dynamic_state_;
+        shader_object_commands shader_objects_;
+        VkPhysicalDeviceMemoryProperties memory_properties_{};
+        bool memory_budget_supported_{};
+        std::array<heap_budget, VK_MAX_MEMORY_HEAPS> memory_budget_{};
+        std::unique_ptr<device_allocator> allocator_;
     };
 
     vulkan_device create_device(vulkan_context const& context);
@@ -77,10 +160,58 @@ inline constexpr uint32_t vkpong::vulkan_device::present_family() const noexcept
     return present_family_;
 }
 
+inline constexpr uint32_t
+vkpong::vulkan_device::transfer_family() const noexcept
+{
+    return transfer_family_;
+}
+
 inline constexpr VkSampleCountFlagBits
 vkpong::vulkan_device::max_msaa_samples() const noexcept
 {
     return max_msaa_samples_;
 }
 
+inline constexpr bool
+vkpong::vulkan_device::pipeline_statistics_supported() const noexcept
+{
+    return pipeline_statistics_supported_;
+}
+
+inline constexpr vkpong::extended_dynamic_state const&
+vkpong::vulkan_device::dynamic_state() const noexcept
+{
+    return dynamic_state_;
+}
+
+inline constexpr vkpong::shader_object_commands const&
+vkpong::vulkan_device::shader_objects() const noexcept
+{
+    return shader_objects_;
+}
+
+inline constexpr bool
+vkpong::vulkan_device::shader_objects_supported() const noexcept
+{
+    return shader_objects_.create_shaders != nullptr;
+}
+
+inline constexpr VkPhysicalDeviceMemoryProperties const&
+vkpong::vulkan_device::memory_properties() const noexcept
+{
+    return memory_properties_;
+}
+
+inline constexpr bool
+vkpong::vulkan_device::memory_budget_supported() const noexcept
+{
+    return memory_budget_supported_;
+}
+
+inline constexpr std::span<vkpong::heap_budget const>
+vkpong::vulkan_device::memory_budget() const noexcept
+{
+    return {memory_budget_.data(), memory_properties_.memoryHeapCount};
+}
+
 #endif // !VKPONG_VULKAN_DEVICE_INCLUDED
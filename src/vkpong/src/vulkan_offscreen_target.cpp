@@ -0,0 +1,156 @@
+#include <vulkan_offscreen_target.hpp>
+
+#include <device_allocator.hpp>
+#include <host_allocator.hpp>
+#include <vulkan_device.hpp>
+#include <vulkan_utility.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+vkpong::vulkan_offscreen_target::vulkan_offscreen_target(
+    vulkan_device* const device,
+    VkExtent2D const extent,
+    VkFormat const image_format)
+    : device_{device}
+    , extent_{extent}
+    , image_format_{image_format}
+{
+    images_.resize(max_frames_in_flight);
+    image_memories_.resize(max_frames_in_flight);
+    image_views_.resize(max_frames_in_flight);
+    for (size_t i{}; i != size_t{max_frames_in_flight}; ++i)
+    {
+        create_image(device_->allocator(),
+            device_->logical(),
+            extent_,
+            1,
+            VK_SAMPLE_COUNT_1_BIT,
+            image_format_,
+            VK_IMAGE_TILING_OPTIMAL,
+            usage,
+            device_local_memory,
+            images_[i],
+            image_memories_[i]);
+
+        image_views_[i] = create_image_view(device_->logical(),
+            images_[i],
+            image_format_,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            1);
+
+        in_flight_fences_.push_back(create_fence(device_->logical(), true));
+    }
+
+    vkGetDeviceQueue(device_->logical(),
+        device_->graphics_family(),
+        0,
+        &graphics_queue_);
+}
+
+vkpong::vulkan_offscreen_target::vulkan_offscreen_target(
+    vulkan_offscreen_target&& other) noexcept
+    : device_{std::exchange(other.device_, nullptr)}
+    , extent_{other.extent_}
+    , image_format_{other.image_format_}
+    , images_{std::move(other.images_)}
+    , image_memories_{std::move(other.image_memories_)}
+    , image_views_{std::move(other.image_views_)}
+    , in_flight_fences_{std::move(other.in_flight_fences_)}
+    , graphics_queue_{other.graphics_queue_}
+{
+}
+
+vkpong::vulkan_offscreen_target::~vulkan_offscreen_target()
+{
+    if (device_)
+    {
+        cleanup();
+    }
+}
+
+bool vkpong::vulkan_offscreen_target::acquire_next_image(
+    uint32_t const current_frame,
+    uint32_t& image_index)
+{
+    constexpr auto timeout{std::numeric_limits<uint64_t>::max()};
+
+    VkFence const& fence{in_flight_fences_[current_frame]};
+    vkWaitForFences(device_->logical(), 1, &fence, VK_TRUE, timeout);
+    vkResetFences(device_->logical(), 1, &fence);
+
+    image_index = current_frame;
+    return true;
+}
+
+bool vkpong::vulkan_offscreen_target::submit_command_buffer(
+    VkCommandBuffer const* const command_buffer,
+    uint32_t const current_frame,
+    [[maybe_unused]] uint32_t const image_index,
+    std::span<VkSemaphoreSubmitInfo const> const wait_semaphores,
+    std::span<VkSemaphoreSubmitInfo const> const signal_semaphores)
+{
+    VkCommandBufferSubmitInfo command_buffer_info{};
+    command_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+    command_buffer_info.commandBuffer = *command_buffer;
+
+    VkSubmitInfo2 submit_info{};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+    submit_info.waitSemaphoreInfoCount = count_cast(wait_semaphores.size());
+    submit_info.pWaitSemaphoreInfos = wait_semaphores.data();
+    submit_info.commandBufferInfoCount = 1;
+    submit_info.pCommandBufferInfos = &command_buffer_info;
+    submit_info.signalSemaphoreInfoCount = count_cast(signal_semaphores.size());
+    submit_info.pSignalSemaphoreInfos = signal_semaphores.data();
+
+    if (vkQueueSubmit2(graphics_queue_,
+            1,
+            &submit_info,
+            in_flight_fences_[current_frame]) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to submit draw command buffer!");
+    }
+
+    return true;
+}
+
+vkpong::vulkan_offscreen_target& vkpong::vulkan_offscreen_target::operator=(
+    vulkan_offscreen_target&& other) noexcept
+{
+    using std::swap;
+
+    if (this != &other)
+    {
+        swap(device_, other.device_);
+        swap(extent_, other.extent_);
+        swap(image_format_, other.image_format_);
+        swap(images_, other.images_);
+        swap(image_memories_, other.image_memories_);
+        swap(image_views_, other.image_views_);
+        swap(in_flight_fences_, other.in_flight_fences_);
+        swap(graphics_queue_, other.graphics_queue_);
+    }
+
+    return *this;
+}
+
+void vkpong::vulkan_offscreen_target::cleanup()
+{
+    for (VkFence const fence : in_flight_fences_)
+    {
+        vkDestroyFence(device_->logical(), fence, allocation_callbacks());
+    }
+
+    for (size_t i{}; i != images_.size(); ++i)
+    {
+        vkDestroyImageView(device_->logical(),
+            image_views_[i],
+            allocation_callbacks());
+        vkDestroyImage(device_->logical(), images_[i], allocation_callbacks());
+        device_->allocator().free(image_memories_[i]);
+    }
+}
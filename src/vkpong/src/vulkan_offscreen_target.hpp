@@ -0,0 +1,130 @@
+#ifndef VKPONG_VULKAN_OFFSCREEN_TARGET_INCLUDED
+#define VKPONG_VULKAN_OFFSCREEN_TARGET_INCLUDED
+
+#include <device_allocator.hpp>
+#include <vulkan_render_target.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace vkpong
+{
+    class vulkan_device;
+} // namespace vkpong
+
+namespace vkpong
+{
+    class [[nodiscard]] vulkan_offscreen_target final
+        : public vulkan_render_target
+    {
+    public: // Constants
+        static constexpr VkImageUsageFlags usage{
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+            VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT};
+
+    public: // Construction
+        vulkan_offscreen_target(vulkan_device* device,
+            VkExtent2D extent,
+            VkFormat image_format = VK_FORMAT_B8G8R8A8_SRGB);
+
+        vulkan_offscreen_target(vulkan_offscreen_target const&) = delete;
+
+        vulkan_offscreen_target(vulkan_offscreen_target&& other) noexcept;
+
+    public: // Destruction
+        ~vulkan_offscreen_target() override;
+
+    public: // Interface
+        [[nodiscard]] VkExtent2D extent() const noexcept override;
+
+        [[nodiscard]] VkQueue graphics_queue() const noexcept override;
+
+        [[nodiscard]] VkFormat image_format() const noexcept override;
+
+        [[nodiscard]] VkImageUsageFlags image_usage() const noexcept override;
+
+        [[nodiscard]] VkImage image(
+            uint32_t image_index) const noexcept override;
+
+        [[nodiscard]] VkImageView image_view(
+            uint32_t image_index) const noexcept override;
+
+        [[nodiscard]] VkImageLayout final_layout() const noexcept override;
+
+        [[nodiscard]] bool acquire_next_image(uint32_t current_frame,
+            uint32_t& image_index) override;
+
+        [[nodiscard]] bool submit_command_buffer(
+            VkCommandBuffer const* command_buffer,
+            uint32_t current_frame,
+            uint32_t image_index,
+            std::span<VkSemaphoreSubmitInfo const> wait_semaphores,
+            std::span<VkSemaphoreSubmitInfo const> signal_semaphores)
+            override;
+
+    public: // Operators
+        vulkan_offscreen_target& operator=(
+            vulkan_offscreen_target const&) = delete;
+
+        vulkan_offscreen_target& operator=(
+            vulkan_offscreen_target&& other) noexcept;
+
+    private: // Helpers
+        void cleanup();
+
+    private: // Data
+        vulkan_device* device_{};
+        VkExtent2D extent_{};
+        VkFormat image_format_{};
+        std::vector<VkImage> images_;
+        std::vector<device_allocation> image_memories_;
+        std::vector<VkImageView> image_views_;
+        std::vector<VkFence> in_flight_fences_;
+
+        VkQueue graphics_queue_{};
+    };
+} // namespace vkpong
+
+inline VkExtent2D vkpong::vulkan_offscreen_target::extent() const noexcept
+{
+    return extent_;
+}
+
+inline VkQueue vkpong::vulkan_offscreen_target::graphics_queue() const noexcept
+{
+    return graphics_queue_;
+}
+
+inline VkFormat vkpong::vulkan_offscreen_target::image_format() const noexcept
+{
+    return image_format_;
+}
+
+inline VkImageUsageFlags
+vkpong::vulkan_offscreen_target::image_usage() const noexcept
+{
+    return usage;
+}
+
+inline VkImage vkpong::vulkan_offscreen_target::image(
+    uint32_t const image_index) const noexcept
+{
+    return images_[image_index];
+}
+
+inline VkImageView vkpong::vulkan_offscreen_target::image_view(
+    uint32_t const image_index) const noexcept
+{
+    return image_views_[image_index];
+}
+
+inline VkImageLayout
+vkpong::vulkan_offscreen_target::final_layout() const noexcept
+{
+    return VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+}
+
+#endif // !VKPONG_VULKAN_OFFSCREEN_TARGET_INCLUDED
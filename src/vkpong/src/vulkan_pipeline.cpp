@@ -1,5 +1,7 @@
 #include <vulkan_pipeline.hpp>
 
+#include <host_allocator.hpp>
+#include <scope_exit.hpp>
 #include <vulkan_device.hpp>
 #include <vulkan_utility.hpp>
 
@@ -38,6 +40,30 @@ namespace
 
 namespace
 {
+    constexpr VkColorComponentFlags all_color_components{
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+        VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT};
+
+    void set_color_blending(VkCommandBuffer const command_buffer,
+        PFN_vkCmdSetColorBlendEnableEXT const set_enable,
+        PFN_vkCmdSetColorBlendEquationEXT const set_equation,
+        std::optional<VkPipelineColorBlendAttachmentState> const& blending)
+    {
+        VkPipelineColorBlendAttachmentState const attachment{
+            blending.value_or(VkPipelineColorBlendAttachmentState{})};
+        VkBool32 const enable{attachment.blendEnable};
+        set_enable(command_buffer, 0, 1, &enable);
+
+        VkColorBlendEquationEXT const equation{
+            .srcColorBlendFactor = attachment.srcColorBlendFactor,
+            .dstColorBlendFactor = attachment.dstColorBlendFactor,
+            .colorBlendOp = attachment.colorBlendOp,
+            .srcAlphaBlendFactor = attachment.srcAlphaBlendFactor,
+            .dstAlphaBlendFactor = attachment.dstAlphaBlendFactor,
+            .alphaBlendOp = attachment.alphaBlendOp};
+        set_equation(command_buffer, 0, 1, &equation);
+    }
+
     [[nodiscard]] VkShaderModule create_shader_module(VkDevice device,
         std::span<char const> code)
     {
@@ -48,8 +74,10 @@ namespace
 
         // TODO-JK: maintenance5 feature
         VkShaderModule module{};
-        if (vkCreateShaderModule(device, &create_info, nullptr, &module) !=
-            VK_SUCCESS)
+        if (vkCreateShaderModule(device,
+                &create_info,
+                vkpong::allocation_callbacks(),
+                &module) != VK_SUCCESS)
         {
             throw std::runtime_error{"failed to create shader module"};
         }
@@ -60,10 +88,30 @@ namespace
 
 vkpong::vulkan_pipeline::vulkan_pipeline(vulkan_device* device,
     VkPipelineLayout pipeline_layout,
-    VkPipeline pipeline)
+    VkPipeline pipeline,
+    pipeline_dynamic_states dynamic_states,
+    pipeline_state const& state)
     : device_{device}
     , pipeline_layout_{pipeline_layout}
     , pipeline_{pipeline}
+    , dynamic_states_{dynamic_states}
+    , state_{state}
+{
+}
+
+vkpong::vulkan_pipeline::vulkan_pipeline(vulkan_device* device,
+    VkPipelineLayout pipeline_layout,
+    std::vector<VkShaderStageFlagBits> shader_stages,
+    std::vector<VkShaderEXT> shaders,
+    pipeline_state const& state)
+    : device_{device}
+    , pipeline_layout_{pipeline_layout}
+    , dynamic_states_{.cull_mode = true,
+          .rasterization_samples = true,
+          .color_blending = true}
+    , state_{state}
+    , shader_stages_{std::move(shader_stages)}
+    , shaders_{std::move(shaders)}
 {
 }
 
@@ -71,6 +119,10 @@ vkpong::vulkan_pipeline::vulkan_pipeline(vulkan_pipeline&& other) noexcept
     : device_{std::exchange(other.device_, nullptr)}
     , pipeline_layout_{std::exchange(other.pipeline_layout_, nullptr)}
     , pipeline_{std::exchange(other.pipeline_, nullptr)}
+    , dynamic_states_{other.dynamic_states_}
+    , state_{other.state_}
+    , shader_stages_{std::move(other.shader_stages_)}
+    , shaders_{std::exchange(other.shaders_, {})}
 {
 }
 
@@ -78,8 +130,18 @@ vkpong::vulkan_pipeline::~vulkan_pipeline()
 {
     if (device_)
     {
-        vkDestroyPipeline(device_->logical(), pipeline_, nullptr);
-        vkDestroyPipelineLayout(device_->logical(), pipeline_layout_, nullptr);
+        for (VkShaderEXT const shader : shaders_)
+        {
+            device_->shader_objects().destroy_shader(device_->logical(),
+                shader,
+                allocation_callbacks());
+        }
+        vkDestroyPipeline(device_->logical(),
+            pipeline_,
+            allocation_callbacks());
+        vkDestroyPipelineLayout(device_->logical(),
+            pipeline_layout_,
+            allocation_callbacks());
     }
 }
 
@@ -93,11 +155,102 @@ vkpong::vulkan_pipeline& vkpong::vulkan_pipeline::operator=(
         swap(device_, other.device_);
         swap(pipeline_layout_, other.pipeline_layout_);
         swap(pipeline_, other.pipeline_);
+        swap(dynamic_states_, other.dynamic_states_);
+        swap(state_, other.state_);
+        swap(shader_stages_, other.shader_stages_);
+        swap(shaders_, other.shaders_);
     }
 
     return *this;
 }
 
+void vkpong::vulkan_pipeline::bind(VkCommandBuffer const command_buffer) const
+{
+    bind(command_buffer, state_);
+}
+
+void vkpong::vulkan_pipeline::bind(VkCommandBuffer const command_buffer,
+    pipeline_state const& state) const
+{
+    if (shaders_.empty())
+    {
+        vkCmdBindPipeline(command_buffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            pipeline_);
+        set_dynamic_state(command_buffer, state);
+        return;
+    }
+
+    device_->shader_objects().bind_shaders(command_buffer,
+        count_cast(shaders_.size()),
+        shader_stages_.data(),
+        shaders_.data());
+    set_shader_object_state(command_buffer, state);
+}
+
+void vkpong::vulkan_pipeline::set_dynamic_state(
+    VkCommandBuffer const command_buffer,
+    pipeline_state const& state) const
+{
+    if (dynamic_states_.cull_mode)
+    {
+        vkCmdSetCullMode(command_buffer, state.cull_mode);
+        vkCmdSetFrontFace(command_buffer, state.front_face);
+    }
+
+    extended_dynamic_state const& commands{device_->dynamic_state()};
+    if (dynamic_states_.rasterization_samples)
+    {
+        commands.set_rasterization_samples(command_buffer,
+            state.rasterization_samples);
+    }
+
+    if (dynamic_states_.color_blending)
+    {
+        set_color_blending(command_buffer,
+            commands.set_color_blend_enable,
+            commands.set_color_blend_equation,
+            state.color_blending);
+    }
+}
+
+void vkpong::vulkan_pipeline::set_shader_object_state(
+    VkCommandBuffer const command_buffer,
+    pipeline_state const& state) const
+{
+    shader_object_commands const& commands{device_->shader_objects()};
+
+    vkCmdSetRasterizerDiscardEnable(command_buffer, VK_FALSE);
+    vkCmdSetPrimitiveTopology(command_buffer,
+        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+    vkCmdSetPrimitiveRestartEnable(command_buffer, VK_FALSE);
+    vkCmdSetCullMode(command_buffer, state.cull_mode);
+    vkCmdSetFrontFace(command_buffer, state.front_face);
+    vkCmdSetDepthTestEnable(command_buffer, VK_FALSE);
+    vkCmdSetDepthWriteEnable(command_buffer, VK_FALSE);
+    vkCmdSetDepthBiasEnable(command_buffer, VK_FALSE);
+    vkCmdSetStencilTestEnable(command_buffer, VK_FALSE);
+
+    commands.set_vertex_input(command_buffer, 0, nullptr, 0, nullptr);
+    commands.set_polygon_mode(command_buffer, VK_POLYGON_MODE_FILL);
+    commands.set_rasterization_samples(command_buffer,
+        state.rasterization_samples);
+    VkSampleMask const sample_mask{~VkSampleMask{}};
+    commands.set_sample_mask(command_buffer,
+        state.rasterization_samples,
+        &sample_mask);
+    commands.set_alpha_to_coverage_enable(command_buffer, VK_FALSE);
+
+    set_color_blending(command_buffer,
+        commands.set_color_blend_enable,
+        commands.set_color_blend_equation,
+        state.color_blending);
+    VkColorComponentFlags const write_mask{state.color_blending
+            ? state.color_blending->colorWriteMask
+            : all_color_components};
+    commands.set_color_write_mask(command_buffer, 0, 1, &write_mask);
+}
+
 vkpong::vulkan_pipeline_builder::vulkan_pipeline_builder(
     vulkan_device* const device,
     VkFormat const image_format)
@@ -110,15 +263,178 @@ vkpong::vulkan_pipeline_builder::~vulkan_pipeline_builder() { cleanup(); }
 
 vkpong::vulkan_pipeline vkpong::vulkan_pipeline_builder::build()
 {
+    // Storage is reserved up front, stage infos point into it.
+    std::vector<VkSpecializationMapEntry> specialization_entries;
+    specialization_entries.reserve(specialization_constants_.size());
+    std::vector<uint32_t> specialization_data;
+    specialization_data.reserve(specialization_constants_.size());
+    std::vector<VkSpecializationInfo> specialization_infos;
+    specialization_infos.reserve(shaders_.size());
+
+    std::vector<VkSpecializationInfo const*> specializations;
+    specializations.reserve(shaders_.size());
+    for (auto const& shader : shaders_)
+    {
+        size_t const first{specialization_data.size()};
+        for (auto const& [stage, constant_id, value] :
+            specialization_constants_)
+        {
+            if (stage != std::get<0>(shader))
+            {
+                continue;
+            }
+
+            specialization_entries.push_back({.constantID = constant_id,
+                .offset = count_cast(
+                    (specialization_data.size() - first) * sizeof(uint32_t)),
+                .size = sizeof(uint32_t)});
+            specialization_data.push_back(value);
+        }
+
+        VkSpecializationInfo const* info{};
+        if (size_t const count{specialization_data.size() - first}; count != 0)
+        {
+            specialization_infos.push_back({.mapEntryCount = count_cast(count),
+                .pMapEntries = specialization_entries.data() + first,
+                .dataSize = count * sizeof(uint32_t),
+                .pData = specialization_data.data() + first});
+            info = &specialization_infos.back();
+        }
+        specializations.push_back(info);
+    }
+
+    bool const use_shader_objects{shader_objects_ &&
+        device_->shader_objects_supported() && !min_sample_shading_ &&
+        vertex_input_binding_.empty()};
+
+    vulkan_pipeline rv{use_shader_objects
+            ? build_shader_objects(specializations)
+            : build_pipeline(specializations)};
+
+    cleanup();
+
+    return rv;
+}
+
+VkPipelineLayout vkpong::vulkan_pipeline_builder::create_pipeline_layout() const
+{
+    VkPipelineLayoutCreateInfo pipeline_layout_info{};
+    pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    if (push_constants_)
+    {
+        pipeline_layout_info.pushConstantRangeCount = 1;
+        pipeline_layout_info.pPushConstantRanges = &(*push_constants_);
+    }
+
+    pipeline_layout_info.setLayoutCount =
+        count_cast(descriptor_set_layouts_.size());
+    pipeline_layout_info.pSetLayouts = descriptor_set_layouts_.data();
+
+    VkPipelineLayout rv{};
+    if (vkCreatePipelineLayout(device_->logical(),
+            &pipeline_layout_info,
+            allocation_callbacks(),
+            &rv) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to create pipeline layout!"};
+    }
+
+    return rv;
+}
+
+vkpong::pipeline_state vkpong::vulkan_pipeline_builder::baked_state() const
+{
+    return {.cull_mode = cull_mode_,
+        .front_face = front_face_,
+        .rasterization_samples = rasterization_samples_,
+        .color_blending = color_blend_attachment_};
+}
+
+vkpong::vulkan_pipeline vkpong::vulkan_pipeline_builder::build_shader_objects(
+    std::span<VkSpecializationInfo const* const> const specializations)
+{
+    VkPipelineLayout const pipeline_layout{create_pipeline_layout()};
+
+    std::vector<VkShaderStageFlagBits> stages;
+    stages.reserve(shaders_.size());
+    std::vector<VkShaderCreateInfoEXT> create_infos;
+    create_infos.reserve(shaders_.size());
+    for (size_t i{}; i != shaders_.size(); ++i)
+    {
+        auto const& [stage, code, name] = shaders_[i];
+
+        VkShaderCreateInfoEXT create_info{};
+        create_info.sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT;
+        if (shaders_.size() > 1)
+        {
+            create_info.flags = VK_SHADER_CREATE_LINK_STAGE_BIT_EXT;
+        }
+        create_info.stage = stage;
+        if (i + 1 != shaders_.size())
+        {
+            create_info.nextStage = std::get<0>(shaders_[i + 1]);
+        }
+        create_info.codeType = VK_SHADER_CODE_TYPE_SPIRV_EXT;
+        create_info.codeSize = code.size();
+        create_info.pCode = code.data();
+        create_info.pName = name.c_str();
+        create_info.setLayoutCount = count_cast(descriptor_set_layouts_.size());
+        create_info.pSetLayouts = descriptor_set_layouts_.data();
+        if (push_constants_)
+        {
+            create_info.pushConstantRangeCount = 1;
+            create_info.pPushConstantRanges = &(*push_constants_);
+        }
+        create_info.pSpecializationInfo = specializations[i];
+
+        stages.push_back(stage);
+        create_infos.push_back(create_info);
+    }
+
+    std::vector<VkShaderEXT> shaders(create_infos.size());
+    if (device_->shader_objects().create_shaders(device_->logical(),
+            count_cast(create_infos.size()),
+            create_infos.data(),
+            allocation_callbacks(),
+            shaders.data()) != VK_SUCCESS)
+    {
+        vkDestroyPipelineLayout(device_->logical(),
+            pipeline_layout,
+            allocation_callbacks());
+        throw std::runtime_error{"failed to create shader objects!"};
+    }
+
+    return {device_,
+        pipeline_layout,
+        std::move(stages),
+        std::move(shaders),
+        baked_state()};
+}
+
+vkpong::vulkan_pipeline vkpong::vulkan_pipeline_builder::build_pipeline(
+    std::span<VkSpecializationInfo const* const> const specializations)
+{
+    std::vector<VkShaderModule> modules;
+    modules.reserve(shaders_.size());
+    VKPONG_ON_SCOPE_EXIT(for (VkShaderModule const module : modules) {
+        vkDestroyShaderModule(device_->logical(),
+            module,
+            allocation_callbacks());
+    });
+
     std::vector<VkPipelineShaderStageCreateInfo> shader_stages;
     shader_stages.reserve(shaders_.size());
-    for (auto const& shader : shaders_)
+    for (size_t i{}; i != shaders_.size(); ++i)
     {
+        auto const& [stage, code, name] = shaders_[i];
+        modules.push_back(create_shader_module(device_->logical(), code));
+
         VkPipelineShaderStageCreateInfo create_info{};
         create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        create_info.stage = std::get<0>(shader);
-        create_info.module = std::get<1>(shader);
-        create_info.pName = std::get<2>(shader).c_str();
+        create_info.stage = stage;
+        create_info.module = modules.back();
+        create_info.pName = name.c_str();
+        create_info.pSpecializationInfo = specializations[i];
 
         shader_stages.push_back(create_info);
     }
@@ -143,8 +459,9 @@ vkpong::vulkan_pipeline vkpong::vulkan_pipeline_builder::build()
     VkPipelineViewportStateCreateInfo viewport_state{};
     viewport_state.sType =
         VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewport_state.viewportCount = 1;
-    viewport_state.scissorCount = 1;
+    // Counts are set with the viewports and scissors while recording.
+    viewport_state.viewportCount = 0;
+    viewport_state.scissorCount = 0;
 
     VkPipelineRasterizationStateCreateInfo rasterizer{};
     rasterizer.sType =
@@ -152,23 +469,26 @@ vkpong::vulkan_pipeline vkpong::vulkan_pipeline_builder::build()
     rasterizer.depthClampEnable = VK_FALSE;
     rasterizer.rasterizerDiscardEnable = VK_FALSE;
     rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    rasterizer.cullMode = cull_mode_;
+    rasterizer.frontFace = front_face_;
     rasterizer.depthBiasEnable = VK_FALSE;
     rasterizer.lineWidth = 1.0f;
 
     VkPipelineMultisampleStateCreateInfo multisampling{};
     multisampling.sType =
         VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.sampleShadingEnable = VK_TRUE;
-    multisampling.minSampleShading = .2f;
+    multisampling.sampleShadingEnable =
+        min_sample_shading_ ? VK_TRUE : VK_FALSE;
+    multisampling.minSampleShading = min_sample_shading_.value_or(0.0f);
     multisampling.rasterizationSamples = rasterization_samples_;
 
     VkPipelineColorBlendAttachmentState color_blend_attachment{};
     color_blend_attachment.blendEnable = VK_FALSE,
-    color_blend_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT |
-        VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT |
-        VK_COLOR_COMPONENT_A_BIT;
+    color_blend_attachment.colorWriteMask = all_color_components;
+    if (color_blend_attachment_)
+    {
+        color_blend_attachment = *color_blend_attachment_;
+    }
 
     VkPipelineColorBlendStateCreateInfo color_blending{};
     color_blending.sType =
@@ -179,33 +499,42 @@ vkpong::vulkan_pipeline vkpong::vulkan_pipeline_builder::build()
     color_blending.pAttachments = &color_blend_attachment;
     std::ranges::fill(color_blending.blendConstants, 0.0f);
 
-    constexpr std::array dynamic_states = {VK_DYNAMIC_STATE_VIEWPORT,
-        VK_DYNAMIC_STATE_SCISSOR};
+    std::vector<VkDynamicState> dynamic_states{
+        VK_DYNAMIC_STATE_VIEWPORT_WITH_COUNT,
+        VK_DYNAMIC_STATE_SCISSOR_WITH_COUNT};
+    pipeline_dynamic_states enabled_dynamic_states;
+    if (extended_dynamic_state_)
+    {
+        extended_dynamic_state const& supported{device_->dynamic_state()};
+
+        // Core since Vulkan 1.3.
+        enabled_dynamic_states.cull_mode = true;
+        dynamic_states.push_back(VK_DYNAMIC_STATE_CULL_MODE);
+        dynamic_states.push_back(VK_DYNAMIC_STATE_FRONT_FACE);
+
+        if (supported.set_rasterization_samples)
+        {
+            enabled_dynamic_states.rasterization_samples = true;
+            dynamic_states.push_back(
+                VK_DYNAMIC_STATE_RASTERIZATION_SAMPLES_EXT);
+        }
+
+        if (supported.set_color_blend_enable &&
+            supported.set_color_blend_equation)
+        {
+            enabled_dynamic_states.color_blending = true;
+            dynamic_states.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+            dynamic_states.push_back(
+                VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT);
+        }
+    }
+
     VkPipelineDynamicStateCreateInfo dynamic_state{};
     dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
     dynamic_state.dynamicStateCount = count_cast(dynamic_states.size()),
     dynamic_state.pDynamicStates = dynamic_states.data();
 
-    VkPipelineLayoutCreateInfo pipeline_layout_info{};
-    pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    if (push_constants_)
-    {
-        pipeline_layout_info.pushConstantRangeCount = 1;
-        pipeline_layout_info.pPushConstantRanges = &(*push_constants_);
-    }
-
-    pipeline_layout_info.setLayoutCount =
-        count_cast(descriptor_set_layouts_.size());
-    pipeline_layout_info.pSetLayouts = descriptor_set_layouts_.data();
-
-    VkPipelineLayout pipeline_layout{};
-    if (vkCreatePipelineLayout(device_->logical(),
-            &pipeline_layout_info,
-            nullptr,
-            &pipeline_layout) != VK_SUCCESS)
-    {
-        throw std::runtime_error{"failed to create pipeline layout!"};
-    }
+    VkPipelineLayout const pipeline_layout{create_pipeline_layout()};
 
     VkPipelineRenderingCreateInfoKHR rendering_create_info{};
     rendering_create_info.sType =
@@ -232,16 +561,20 @@ vkpong::vulkan_pipeline vkpong::vulkan_pipeline_builder::build()
             VK_NULL_HANDLE,
             1,
             &create_info,
-            nullptr,
+            allocation_callbacks(),
             &pipeline) != VK_SUCCESS)
     {
-        vkDestroyPipelineLayout(device_->logical(), pipeline_layout, nullptr);
+        vkDestroyPipelineLayout(device_->logical(),
+            pipeline_layout,
+            allocation_callbacks());
         throw std::runtime_error{"failed to create pipeline!"};
     }
 
-    cleanup();
-
-    return {device_, pipeline_layout, pipeline};
+    return {device_,
+        pipeline_layout,
+        pipeline,
+        enabled_dynamic_states,
+        baked_state()};
 }
 
 vkpong::vulkan_pipeline_builder& vkpong::vulkan_pipeline_builder::add_shader(
@@ -249,12 +582,17 @@ vkpong::vulkan_pipeline_builder& vkpong::vulkan_pipeline_builder::add_shader(
     std::filesystem::path const& path,
     std::string_view entry_point)
 {
-    std::string name{entry_point};
-    shaders_.reserve(shaders_.size() + 1);
+    shaders_.emplace_back(stage, read_file(path), std::string{entry_point});
+    return *this;
+}
 
-    shaders_.emplace_back(stage,
-        create_shader_module(device_->logical(), read_file(path)),
-        std::move(name));
+vkpong::vulkan_pipeline_builder&
+vkpong::vulkan_pipeline_builder::add_specialization_constant(
+    VkShaderStageFlagBits const stage,
+    uint32_t const constant_id,
+    uint32_t const value)
+{
+    specialization_constants_.emplace_back(stage, constant_id, value);
     return *this;
 }
 
@@ -293,6 +631,14 @@ vkpong::vulkan_pipeline_builder::with_rasterization_samples(
     return *this;
 }
 
+vkpong::vulkan_pipeline_builder&
+vkpong::vulkan_pipeline_builder::with_sample_shading(
+    float const min_sample_shading)
+{
+    min_sample_shading_ = min_sample_shading;
+    return *this;
+}
+
 vkpong::vulkan_pipeline_builder&
 vkpong::vulkan_pipeline_builder::with_push_constants(
     VkPushConstantRange const push_constants)
@@ -302,16 +648,103 @@ vkpong::vulkan_pipeline_builder::with_push_constants(
     return *this;
 }
 
+vkpong::vulkan_pipeline_builder&
+vkpong::vulkan_pipeline_builder::with_color_blending(
+    VkPipelineColorBlendAttachmentState const color_blend_attachment)
+{
+    color_blend_attachment_ = color_blend_attachment;
+
+    return *this;
+}
+
+vkpong::vulkan_pipeline_builder&
+vkpong::vulkan_pipeline_builder::with_cull_mode(
+    VkCullModeFlags const cull_mode,
+    VkFrontFace const front_face)
+{
+    cull_mode_ = cull_mode;
+    front_face_ = front_face;
+
+    return *this;
+}
+
+vkpong::vulkan_pipeline_builder&
+vkpong::vulkan_pipeline_builder::with_extended_dynamic_state()
+{
+    extended_dynamic_state_ = true;
+
+    return *this;
+}
+
+vkpong::vulkan_pipeline_builder&
+vkpong::vulkan_pipeline_builder::with_shader_objects()
+{
+    shader_objects_ = true;
+
+    return *this;
+}
+
 void vkpong::vulkan_pipeline_builder::cleanup()
 {
     descriptor_set_layouts_.clear();
     vertex_input_attributes_.clear();
     vertex_input_binding_.clear();
+    shaders_.clear();
+}
 
-    for (auto const& shader : shaders_)
+vkpong::vulkan_pipeline vkpong::create_compute_pipeline(
+    vulkan_device* const device,
+    std::filesystem::path const& path,
+    std::span<VkDescriptorSetLayout const> const descriptor_set_layouts,
+    std::optional<VkPushConstantRange> const push_constants)
+{
+    VkPipelineLayoutCreateInfo pipeline_layout_info{};
+    pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    if (push_constants)
     {
-        vkDestroyShaderModule(device_->logical(), std::get<1>(shader), nullptr);
+        pipeline_layout_info.pushConstantRangeCount = 1;
+        pipeline_layout_info.pPushConstantRanges = &(*push_constants);
     }
+    pipeline_layout_info.setLayoutCount =
+        count_cast(descriptor_set_layouts.size());
+    pipeline_layout_info.pSetLayouts = descriptor_set_layouts.data();
 
-    shaders_.clear();
+    VkPipelineLayout pipeline_layout{};
+    if (vkCreatePipelineLayout(device->logical(),
+            &pipeline_layout_info,
+            allocation_callbacks(),
+            &pipeline_layout) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to create pipeline layout!"};
+    }
+
+    VkShaderModule const module{
+        create_shader_module(device->logical(), read_file(path))};
+
+    VkComputePipelineCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    create_info.stage.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    create_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    create_info.stage.module = module;
+    create_info.stage.pName = "main";
+    create_info.layout = pipeline_layout;
+
+    VkPipeline pipeline{};
+    VkResult const result{vkCreateComputePipelines(device->logical(),
+        VK_NULL_HANDLE,
+        1,
+        &create_info,
+        allocation_callbacks(),
+        &pipeline)};
+    vkDestroyShaderModule(device->logical(), module, allocation_callbacks());
+    if (result != VK_SUCCESS)
+    {
+        vkDestroyPipelineLayout(device->logical(),
+            pipeline_layout,
+            allocation_callbacks());
+        throw std::runtime_error{"failed to create compute pipeline!"};
+    }
+
+    return {device, pipeline_layout, pipeline};
 }
@@ -3,6 +3,7 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstdint>
 #include <filesystem>
 #include <optional>
 #include <span>
@@ -18,12 +19,39 @@ namespace vkpong
 
 namespace vkpong
 {
+    // Fixed function state applied while recording, only the states left
+    // dynamic by the pipeline are set.
+    struct [[nodiscard]] pipeline_state final
+    {
+        VkCullModeFlags cull_mode{VK_CULL_MODE_BACK_BIT};
+        VkFrontFace front_face{VK_FRONT_FACE_CLOCKWISE};
+        VkSampleCountFlagBits rasterization_samples{VK_SAMPLE_COUNT_1_BIT};
+        std::optional<VkPipelineColorBlendAttachmentState> color_blending;
+    };
+
+    struct [[nodiscard]] pipeline_dynamic_states final
+    {
+        bool cull_mode{};
+        bool rasterization_samples{};
+        bool color_blending{};
+    };
+
+    // Either a monolithic pipeline or linked shader objects with every
+    // state set while recording.
     class [[nodiscard]] vulkan_pipeline final
     {
     public: // Construction
         vulkan_pipeline(vulkan_device* device,
             VkPipelineLayout pipeline_layout,
-            VkPipeline pipeline);
+            VkPipeline pipeline,
+            pipeline_dynamic_states dynamic_states = {},
+            pipeline_state const& state = {});
+
+        vulkan_pipeline(vulkan_device* device,
+            VkPipelineLayout pipeline_layout,
+            std::vector<VkShaderStageFlagBits> shader_stages,
+            std::vector<VkShaderEXT> shaders,
+            pipeline_state const& state);
 
         vulkan_pipeline(vulkan_pipeline const&) = delete;
 
@@ -38,15 +66,39 @@ namespace vkpong
         [[nodiscard]] constexpr VkPipelineLayout
         pipeline_layout() const noexcept;
 
+        [[nodiscard]] constexpr pipeline_dynamic_states const&
+        dynamic_states() const noexcept;
+
+        [[nodiscard]] constexpr bool uses_shader_objects() const noexcept;
+
+        // Binds to the graphics bind point with the state given to the
+        // builder.
+        void bind(VkCommandBuffer command_buffer) const;
+
+        // States baked into a pipeline ignore the given values.
+        void bind(VkCommandBuffer command_buffer,
+            pipeline_state const& state) const;
+
     public: // Operators
         vulkan_pipeline& operator=(vulkan_pipeline const&) = delete;
 
         vulkan_pipeline& operator=(vulkan_pipeline&& other) noexcept;
 
+    private: // Helpers
+        void set_dynamic_state(VkCommandBuffer command_buffer,
+            pipeline_state const& state) const;
+
+        void set_shader_object_state(VkCommandBuffer command_buffer,
+            pipeline_state const& state) const;
+
     private: // Data
         vulkan_device* device_{};
         VkPipelineLayout pipeline_layout_{};
         VkPipeline pipeline_{};
+        pipeline_dynamic_states dynamic_states_;
+        pipeline_state state_;
+        std::vector<VkShaderStageFlagBits> shader_stages_;
+        std::vector<VkShaderEXT> shaders_;
     };
 
     class [[nodiscard]] vulkan_pipeline_builder final
@@ -68,6 +120,12 @@ namespace vkpong
             std::filesystem::path const& path,
             std::string_view entry_point);
 
+        // Constants are 32 bit, booleans are passed as VK_TRUE or VK_FALSE.
+        vulkan_pipeline_builder& add_specialization_constant(
+            VkShaderStageFlagBits stage,
+            uint32_t constant_id,
+            uint32_t value);
+
         vulkan_pipeline_builder& add_vertex_input(
             std::span<VkVertexInputBindingDescription const>
                 binding_descriptions,
@@ -80,9 +138,28 @@ namespace vkpong
         vulkan_pipeline_builder& with_rasterization_samples(
             VkSampleCountFlagBits samples);
 
+        vulkan_pipeline_builder& with_sample_shading(
+            float min_sample_shading);
+
         vulkan_pipeline_builder& with_push_constants(
             VkPushConstantRange push_constants);
 
+        vulkan_pipeline_builder& with_color_blending(
+            VkPipelineColorBlendAttachmentState color_blend_attachment);
+
+        vulkan_pipeline_builder& with_cull_mode(VkCullModeFlags cull_mode,
+            VkFrontFace front_face);
+
+        // Cull mode, front face, rasterization samples and color blending
+        // are left dynamic where the device supports it, others are baked
+        // from the builder settings.
+        vulkan_pipeline_builder& with_extended_dynamic_state();
+
+        // Builds linked shader objects instead of a pipeline when the
+        // device supports them. Sample shading and vertex input need a
+        // pipeline. Shaders must be added in pipeline stage order.
+        vulkan_pipeline_builder& with_shader_objects();
+
     public: // Operators
         vulkan_pipeline_builder& operator=(
             vulkan_pipeline_builder const&) = delete;
@@ -91,20 +168,45 @@ namespace vkpong
             vulkan_pipeline_builder&&) noexcept = delete;
 
     private: // Helpers
+        [[nodiscard]] VkPipelineLayout create_pipeline_layout() const;
+
+        [[nodiscard]] pipeline_state baked_state() const;
+
+        [[nodiscard]] vulkan_pipeline build_shader_objects(
+            std::span<VkSpecializationInfo const* const> specializations);
+
+        [[nodiscard]] vulkan_pipeline build_pipeline(
+            std::span<VkSpecializationInfo const* const> specializations);
+
         void cleanup();
 
     private: // Data
         vulkan_device* device_{};
         VkFormat image_format_{};
         std::vector<
-            std::tuple<VkShaderStageFlagBits, VkShaderModule, std::string>>
+            std::tuple<VkShaderStageFlagBits, std::vector<char>, std::string>>
             shaders_;
+        std::vector<std::tuple<VkShaderStageFlagBits, uint32_t, uint32_t>>
+            specialization_constants_;
         std::vector<VkVertexInputBindingDescription> vertex_input_binding_;
         std::vector<VkVertexInputAttributeDescription> vertex_input_attributes_;
         std::vector<VkDescriptorSetLayout> descriptor_set_layouts_;
         VkSampleCountFlagBits rasterization_samples_{VK_SAMPLE_COUNT_1_BIT};
+        std::optional<float> min_sample_shading_;
         std::optional<VkPushConstantRange> push_constants_;
+        std::optional<VkPipelineColorBlendAttachmentState>
+            color_blend_attachment_;
+        VkCullModeFlags cull_mode_{VK_CULL_MODE_BACK_BIT};
+        VkFrontFace front_face_{VK_FRONT_FACE_CLOCKWISE};
+        bool extended_dynamic_state_{};
+        bool shader_objects_{};
     };
+
+    [[nodiscard]] vulkan_pipeline create_compute_pipeline(
+        vulkan_device* device,
+        std::filesystem::path const& path,
+        std::span<VkDescriptorSetLayout const> descriptor_set_layouts,
+        std::optional<VkPushConstantRange> push_constants = std::nullopt);
 } // namespace vkpong
 
 inline constexpr VkPipeline vkpong::vulkan_pipeline::pipeline() const noexcept
@@ -118,4 +220,16 @@ vkpong::vulkan_pipeline::pipeline_layout() const noexcept
     return pipeline_layout_;
 }
 
+inline constexpr vkpong::pipeline_dynamic_states const&
+vkpong::vulkan_pipeline::dynamic_states() const noexcept
+{
+    return dynamic_states_;
+}
+
+inline constexpr bool
+vkpong::vulkan_pipeline::uses_shader_objects() const noexcept
+{
+    return !shaders_.empty();
+}
+
 #endif // !VKPONG_VULKAN_PIPELINE_INCLUDED
@@ -0,0 +1,304 @@
+#include <vulkan_profiler.hpp>
+
+#include <host_allocator.hpp>
+#include <vulkan_device.hpp>
+#include <vulkan_utility.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    [[nodiscard]] uint32_t timestamp_valid_bits(
+        vkpong::vulkan_device const* const device)
+    {
+        uint32_t count{};
+        vkGetPhysicalDeviceQueueFamilyProperties(device->physical(),
+            &count,
+            nullptr);
+
+        std::vector<VkQueueFamilyProperties> families(count);
+        vkGetPhysicalDeviceQueueFamilyProperties(device->physical(),
+            &count,
+            families.data());
+
+        return families[device->graphics_family()].timestampValidBits;
+    }
+
+    constexpr VkQueryPipelineStatisticFlags statistics_flags{
+        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT};
+
+    // Two statistic values followed by the availability value.
+    constexpr size_t statistics_query_stride{3};
+
+    [[nodiscard]] VkQueryPool create_query_pool(VkDevice const device,
+        VkQueryType const type,
+        uint32_t const count,
+        VkQueryPipelineStatisticFlags const statistics)
+    {
+        VkQueryPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        pool_info.queryType = type;
+        pool_info.queryCount = count;
+        pool_info.pipelineStatistics = statistics;
+
+        VkQueryPool rv{};
+        if (vkCreateQueryPool(device,
+                &pool_info,
+                vkpong::allocation_callbacks(),
+                &rv) != VK_SUCCESS)
+        {
+            throw std::runtime_error{"failed to create query pool!"};
+        }
+
+        return rv;
+    }
+
+    [[nodiscard]] double percentile(std::span<double const> const sorted,
+        double const fraction)
+    {
+        auto const index{static_cast<size_t>(
+            fraction * static_cast<double>(sorted.size() - 1) + 0.5)};
+        return sorted[index];
+    }
+} // namespace
+
+vkpong::vulkan_profiler::vulkan_profiler(vulkan_device* const device,
+    std::vector<std::string> pass_names)
+    : device_{device}
+    , pass_names_{std::move(pass_names)}
+    , history_(pass_names_.size())
+    , statistics_supported_{device->pipeline_statistics_supported()}
+    , statistics_(pass_names_.size())
+{
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(device_->physical(), &properties);
+
+    uint32_t const valid_bits{timestamp_valid_bits(device_)};
+    enabled_ = valid_bits != 0 && properties.limits.timestampPeriod > 0;
+    if (enabled_)
+    {
+        timestamp_period_ = properties.limits.timestampPeriod;
+        timestamp_mask_ = valid_bits >= 64 ? ~uint64_t{0}
+                                           : (uint64_t{1} << valid_bits) - 1;
+
+        results_.resize(pass_names_.size() * 4);
+        for (VkQueryPool& pool : query_pools_)
+        {
+            pool = create_query_pool(device_->logical(),
+                VK_QUERY_TYPE_TIMESTAMP,
+                count_cast(pass_names_.size() * 2),
+                0);
+        }
+    }
+
+    if (statistics_supported_)
+    {
+        statistics_results_.resize(
+            pass_names_.size() * statistics_query_stride);
+        for (VkQueryPool& pool : statistics_pools_)
+        {
+            pool = create_query_pool(device_->logical(),
+                VK_QUERY_TYPE_PIPELINE_STATISTICS,
+                count_cast(pass_names_.size()),
+                statistics_flags);
+        }
+    }
+}
+
+vkpong::vulkan_profiler::~vulkan_profiler()
+{
+    for (VkQueryPool const pool : query_pools_)
+    {
+        vkDestroyQueryPool(device_->logical(), pool, allocation_callbacks());
+    }
+
+    for (VkQueryPool const pool : statistics_pools_)
+    {
+        vkDestroyQueryPool(device_->logical(), pool, allocation_callbacks());
+    }
+}
+
+vkpong::pass_timings vkpong::vulkan_profiler::timings(size_t const pass) const
+{
+    pass_history const& history{history_[pass]};
+    if (history.count == 0)
+    {
+        return {};
+    }
+
+    std::vector<double> sorted{history.samples.cbegin(),
+        history.samples.cbegin() + static_cast<ptrdiff_t>(history.count)};
+    std::ranges::sort(sorted);
+
+    double sum{};
+    for (double const sample : sorted)
+    {
+        sum += sample;
+    }
+
+    return {.average = sum / static_cast<double>(sorted.size()),
+        .p50 = percentile(sorted, 0.5),
+        .p95 = percentile(sorted, 0.95),
+        .p99 = percentile(sorted, 0.99)};
+}
+
+void vkpong::vulkan_profiler::reset() noexcept
+{
+    for (pass_history& history : history_)
+    {
+        history = {};
+    }
+
+    std::ranges::fill(statistics_, pass_statistics{});
+    latest_frame_ms_ = 0;
+}
+
+void vkpong::vulkan_profiler::begin_frame(VkCommandBuffer const command_buffer,
+    uint32_t const frame)
+{
+    // Called after the frame slot fence was waited on, results are either
+    // available or the pass was not recorded at all.
+    collect_timestamps(frame);
+    collect_statistics(frame);
+
+    current_frame_ = frame;
+
+    if (enabled_)
+    {
+        vkCmdResetQueryPool(command_buffer,
+            query_pools_[frame],
+            0,
+            count_cast(pass_names_.size() * 2));
+        pending_[frame] = true;
+    }
+
+    if (statistics_enabled_)
+    {
+        vkCmdResetQueryPool(command_buffer,
+            statistics_pools_[frame],
+            0,
+            count_cast(pass_names_.size()));
+        statistics_pending_[frame] = true;
+    }
+}
+
+void vkpong::vulkan_profiler::begin_pass(VkCommandBuffer const command_buffer,
+    size_t const pass)
+{
+    if (pending_[current_frame_])
+    {
+        vkCmdWriteTimestamp2(command_buffer,
+            VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+            query_pools_[current_frame_],
+            count_cast(pass * 2));
+    }
+
+    if (statistics_pending_[current_frame_])
+    {
+        vkCmdBeginQuery(command_buffer,
+            statistics_pools_[current_frame_],
+            count_cast(pass),
+            0);
+    }
+}
+
+void vkpong::vulkan_profiler::end_pass(VkCommandBuffer const command_buffer,
+    size_t const pass)
+{
+    if (statistics_pending_[current_frame_])
+    {
+        vkCmdEndQuery(command_buffer,
+            statistics_pools_[current_frame_],
+            count_cast(pass));
+    }
+
+    if (pending_[current_frame_])
+    {
+        vkCmdWriteTimestamp2(command_buffer,
+            VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT,
+            query_pools_[current_frame_],
+            count_cast(pass * 2 + 1));
+    }
+}
+
+void vkpong::vulkan_profiler::collect_timestamps(uint32_t const frame)
+{
+    latest_frame_ms_ = 0;
+    if (!pending_[frame])
+    {
+        return;
+    }
+    pending_[frame] = false;
+
+    VkResult const result{vkGetQueryPoolResults(device_->logical(),
+        query_pools_[frame],
+        0,
+        count_cast(pass_names_.size() * 2),
+        results_.size() * sizeof(uint64_t),
+        results_.data(),
+        2 * sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT)};
+    if (result != VK_SUCCESS && result != VK_NOT_READY)
+    {
+        return;
+    }
+
+    for (size_t pass{}; pass != pass_names_.size(); ++pass)
+    {
+        uint64_t const* const query{&results_[pass * 4]};
+        if (query[1] == 0 || query[3] == 0)
+        {
+            continue;
+        }
+
+        uint64_t const ticks{(query[2] - query[0]) & timestamp_mask_};
+        double const milliseconds{
+            static_cast<double>(ticks) * timestamp_period_ / 1e6};
+        latest_frame_ms_ += milliseconds;
+
+        pass_history& history{history_[pass]};
+        history.samples[history.next] = milliseconds;
+        history.next = (history.next + 1) % history_size;
+        history.count = std::min(history.count + 1, history_size);
+    }
+}
+
+void vkpong::vulkan_profiler::collect_statistics(uint32_t const frame)
+{
+    if (!statistics_pending_[frame])
+    {
+        return;
+    }
+    statistics_pending_[frame] = false;
+
+    VkResult const result{vkGetQueryPoolResults(device_->logical(),
+        statistics_pools_[frame],
+        0,
+        count_cast(pass_names_.size()),
+        statistics_results_.size() * sizeof(uint64_t),
+        statistics_results_.data(),
+        statistics_query_stride * sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT)};
+    if (result != VK_SUCCESS && result != VK_NOT_READY)
+    {
+        return;
+    }
+
+    // Values are written in the order of the statistic bits.
+    for (size_t pass{}; pass != pass_names_.size(); ++pass)
+    {
+        uint64_t const* const query{
+            &statistics_results_[pass * statistics_query_stride]};
+        if (query[2] != 0)
+        {
+            statistics_[pass] = {.clipping_primitives = query[0],
+                .fragment_invocations = query[1]};
+        }
+    }
+}
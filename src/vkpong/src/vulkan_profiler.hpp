@@ -0,0 +1,175 @@
+#ifndef VKPONG_VULKAN_PROFILER_INCLUDED
+#define VKPONG_VULKAN_PROFILER_INCLUDED
+
+#include <vulkan_render_target.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vkpong
+{
+    class vulkan_device;
+} // namespace vkpong
+
+namespace vkpong
+{
+    // Milliseconds over the last history_size frames.
+    struct [[nodiscard]] pass_timings final
+    {
+        double average{};
+        double p50{};
+        double p95{};
+        double p99{};
+    };
+
+    // Latest values of the pipeline statistics query around a pass.
+    struct [[nodiscard]] pass_statistics final
+    {
+        uint64_t clipping_primitives{};
+        uint64_t fragment_invocations{};
+    };
+
+    class [[nodiscard]] vulkan_profiler final
+    {
+    public: // Constants
+        static constexpr size_t history_size{240};
+
+    public: // Construction
+        vulkan_profiler(vulkan_device* device,
+            std::vector<std::string> pass_names);
+
+        vulkan_profiler(vulkan_profiler const&) = delete;
+
+        vulkan_profiler(vulkan_profiler&&) noexcept = delete;
+
+    public: // Destruction
+        ~vulkan_profiler();
+
+    public: // Interface
+        [[nodiscard]] constexpr bool enabled() const noexcept;
+
+        [[nodiscard]] size_t pass_count() const noexcept;
+
+        [[nodiscard]] std::string_view pass_name(size_t pass) const;
+
+        [[nodiscard]] pass_timings timings(size_t pass) const;
+
+        // Sum over all passes of the frame collected by the last
+        // begin_frame, zero if no results were available.
+        [[nodiscard]] constexpr double latest_frame_time() const noexcept;
+
+        [[nodiscard]] constexpr bool statistics_supported() const noexcept;
+
+        [[nodiscard]] constexpr bool statistics_enabled() const noexcept;
+
+        void set_statistics_enabled(bool enabled) noexcept;
+
+        [[nodiscard]] pass_statistics statistics(size_t pass) const;
+
+        void reset() noexcept;
+
+        void begin_frame(VkCommandBuffer command_buffer, uint32_t frame);
+
+        void begin_pass(VkCommandBuffer command_buffer, size_t pass);
+
+        void end_pass(VkCommandBuffer command_buffer, size_t pass);
+
+    public: // Operators
+        vulkan_profiler& operator=(vulkan_profiler const&) = delete;
+
+        vulkan_profiler& operator=(vulkan_profiler&&) noexcept = delete;
+
+    private: // Types
+        struct [[nodiscard]] pass_history final
+        {
+            std::array<double, history_size> samples{};
+            size_t next{};
+            size_t count{};
+        };
+
+    private: // Helpers
+        void collect_timestamps(uint32_t frame);
+
+        void collect_statistics(uint32_t frame);
+
+    private: // Data
+        vulkan_device* device_;
+        std::vector<std::string> pass_names_;
+        bool enabled_{};
+        double timestamp_period_{};
+        uint64_t timestamp_mask_{};
+
+        std::array<VkQueryPool, vulkan_render_target::max_frames_in_flight>
+            query_pools_{};
+        std::array<bool, vulkan_render_target::max_frames_in_flight>
+            pending_{};
+        uint32_t current_frame_{};
+
+        std::vector<pass_history> history_;
+        std::vector<uint64_t> results_;
+        double latest_frame_ms_{};
+
+        bool statistics_supported_{};
+        bool statistics_enabled_{};
+        std::array<VkQueryPool, vulkan_render_target::max_frames_in_flight>
+            statistics_pools_{};
+        std::array<bool, vulkan_render_target::max_frames_in_flight>
+            statistics_pending_{};
+        std::vector<pass_statistics> statistics_;
+        std::vector<uint64_t> statistics_results_;
+    };
+} // namespace vkpong
+
+inline constexpr bool vkpong::vulkan_profiler::enabled() const noexcept
+{
+    return enabled_;
+}
+
+inline constexpr double
+vkpong::vulkan_profiler::latest_frame_time() const noexcept
+{
+    return latest_frame_ms_;
+}
+
+inline constexpr bool
+vkpong::vulkan_profiler::statistics_supported() const noexcept
+{
+    return statistics_supported_;
+}
+
+inline constexpr bool
+vkpong::vulkan_profiler::statistics_enabled() const noexcept
+{
+    return statistics_enabled_;
+}
+
+inline void vkpong::vulkan_profiler::set_statistics_enabled(
+    bool const enabled) noexcept
+{
+    statistics_enabled_ = enabled && statistics_supported_;
+}
+
+inline vkpong::pass_statistics vkpong::vulkan_profiler::statistics(
+    size_t const pass) const
+{
+    return statistics_[pass];
+}
+
+inline size_t vkpong::vulkan_profiler::pass_count() const noexcept
+{
+    return pass_names_.size();
+}
+
+inline std::string_view vkpong::vulkan_profiler::pass_name(
+    size_t const pass) const
+{
+    return pass_names_[pass];
+}
+
+#endif // !VKPONG_VULKAN_PROFILER_INCLUDED
@@ -0,0 +1,67 @@
+#ifndef VKPONG_VULKAN_RENDER_TARGET_INCLUDED
+#define VKPONG_VULKAN_RENDER_TARGET_INCLUDED
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace vkpong
+{
+    class [[nodiscard]] vulkan_render_target
+    {
+    public: // Constants
+        static constexpr int max_frames_in_flight{2};
+
+        // Semaphores a renderer may pass to each side of a submission.
+        static constexpr size_t max_submit_semaphores{1};
+
+    public: // Destruction
+        virtual ~vulkan_render_target() = default;
+
+    public: // Interface
+        [[nodiscard]] virtual VkExtent2D extent() const noexcept = 0;
+
+        [[nodiscard]] virtual VkQueue graphics_queue() const noexcept = 0;
+
+        [[nodiscard]] virtual VkFormat image_format() const noexcept = 0;
+
+        [[nodiscard]] virtual VkImageUsageFlags
+        image_usage() const noexcept = 0;
+
+        [[nodiscard]] virtual VkImage image(
+            uint32_t image_index) const noexcept = 0;
+
+        [[nodiscard]] virtual VkImageView image_view(
+            uint32_t image_index) const noexcept = 0;
+
+        [[nodiscard]] virtual VkImageLayout final_layout() const noexcept = 0;
+
+        [[nodiscard]] virtual bool acquire_next_image(uint32_t current_frame,
+            uint32_t& image_index) = 0;
+
+        // At most max_submit_semaphores wait and signal semaphores.
+        [[nodiscard]] virtual bool submit_command_buffer(
+            VkCommandBuffer const* command_buffer,
+            uint32_t current_frame,
+            uint32_t image_index,
+            std::span<VkSemaphoreSubmitInfo const> wait_semaphores,
+            std::span<VkSemaphoreSubmitInfo const> signal_semaphores) = 0;
+
+    protected: // Construction
+        vulkan_render_target() = default;
+
+        vulkan_render_target(vulkan_render_target const&) = default;
+
+        vulkan_render_target(vulkan_render_target&&) noexcept = default;
+
+    protected: // Operators
+        vulkan_render_target& operator=(vulkan_render_target const&) = default;
+
+        vulkan_render_target& operator=(
+            vulkan_render_target&&) noexcept = default;
+    };
+} // namespace vkpong
+
+#endif // !VKPONG_VULKAN_RENDER_TARGET_INCLUDED
@@ -1,10 +1,15 @@
 #include <vulkan_renderer.hpp>
 
+#include <device_allocator.hpp>
 #include <game.hpp>
+#include <host_allocator.hpp>
+#include <mapped_span.hpp>
+#include <particle_system.hpp>
+#include <quad_batcher.hpp>
 #include <vulkan_context.hpp>
 #include <vulkan_device.hpp>
 #include <vulkan_pipeline.hpp>
-#include <vulkan_swap_chain.hpp>
+#include <vulkan_render_target.hpp>
 #include <vulkan_utility.hpp>
 
 #define GLM_FORCE_RADIANS
@@ -15,87 +20,172 @@
 #include <imgui_impl_glfw.hpp>
 #include <imgui_impl_vulkan.hpp>
 
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <optional>
 #include <span>
 #include <stdexcept>
+#include <string>
+#include <utility>
 
 namespace
 {
-    struct [[nodiscard]] push_consts final
+    // Two triangles of the unit quad, corners are generated in the vertex
+    // shader from the vertex index.
+    constexpr uint32_t quad_vertex_count{6};
+
+    // Selects the instance layout read by the quad vertex shader.
+    constexpr uint32_t packed_instances_constant{0};
+
+    constexpr size_t particle_update_pass{vkpong::quad_shape_count};
+    constexpr size_t particle_pass{vkpong::quad_shape_count + 1};
+    constexpr size_t text_pass{vkpong::quad_shape_count + 2};
+    constexpr size_t imgui_pass{vkpong::quad_shape_count + 3};
+
+    constexpr float score_size{0.12f};
+    constexpr glm::fvec2 npc_score_position{-0.3f, -0.95f};
+    constexpr glm::fvec2 player_score_position{0.2f, -0.95f};
+    constexpr glm::fvec3 score_color{1.0f, 1.0f, 1.0f};
+
+    constexpr glm::fvec2 paddle_half_extent{0.02f, 0.2f};
+    constexpr float ball_radius{0.03f};
+
+    // Game coordinates have the y axis pointing up.
+    void submit_entities(vkpong::game const& state,
+        VkExtent2D const extent,
+        vkpong::quad_batcher& batcher)
     {
-        glm::fvec4 color[6];
-    };
+        batcher.add_rectangle({.9f, -state.player_position},
+            paddle_half_extent,
+            {.5f, 0, 0});
+        batcher.add_rectangle({-.9f, -state.npc_position},
+            paddle_half_extent,
+            {0, .5f, 0});
+
+        float const aspect{static_cast<float>(extent.width) /
+            static_cast<float>(extent.height)};
+        batcher.add_circle(
+            {state.ball_position.first, -state.ball_position.second},
+            {ball_radius, ball_radius * aspect},
+            {0, 0, .5f});
+    }
 
-    struct [[nodiscard]] ball_push_consts final
-    {
-        glm::fvec4 color[6];
-        glm::fvec2 resolution;
-    };
+    // Long frames are clamped so particles don't jump across the screen.
+    constexpr float max_particle_step{0.05f};
 
-    struct [[nodiscard]] instance_data final
+    [[nodiscard]] glm::fvec2 to_screen(std::pair<float, float> const position)
     {
-        glm::fvec2 offset;
-        glm::fvec2 dimension;
-        glm::fvec3 color;
-    };
+        return {position.first, -position.second};
+    }
 
-    struct [[nodiscard]] vertex final
+    // Impact bursts for events of the last tick and a trail behind the ball.
+    void emit_particles(vkpong::game const& state,
+        vkpong::particle_system& particles)
     {
-        glm::fvec2 position;
-
-        [[nodiscard]] static constexpr auto binding_description()
+        for (vkpong::game_event const& event : state.events)
         {
-            constexpr std::array descriptions{
-                VkVertexInputBindingDescription{.binding = 0,
-                    .stride = sizeof(vertex),
-                    .inputRate = VK_VERTEX_INPUT_RATE_VERTEX},
-                VkVertexInputBindingDescription{.binding = 1,
-                    .stride = sizeof(instance_data),
-                    .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE},
-            };
-
-            return descriptions;
+            glm::fvec2 const position{to_screen(event.position)};
+            switch (event.type)
+            {
+            case vkpong::game_event_type::paddle_bounce:
+                particles.emit({.position = position,
+                    .direction = {-std::copysign(1.0f, position.x), 0.0f},
+                    .speed = 0.8f,
+                    .spread = 2.5f,
+                    .lifetime = 0.6f,
+                    .color = {1.0f, 0.9f, 0.7f},
+                    .count = 512});
+                break;
+            case vkpong::game_event_type::wall_bounce:
+                particles.emit({.position = position,
+                    .direction = {0.0f, -std::copysign(1.0f, position.y)},
+                    .speed = 0.8f,
+                    .spread = 2.5f,
+                    .lifetime = 0.6f,
+                    .color = {0.6f, 0.8f, 1.0f},
+                    .count = 256});
+                break;
+            case vkpong::game_event_type::goal:
+                particles.emit({.position = position,
+                    .direction = {1.0f, 0.0f},
+                    .speed = 1.2f,
+                    .spread = 6.2832f,
+                    .lifetime = 1.5f,
+                    .color = {1.0f, 0.3f, 0.2f},
+                    .count = 8192});
+                break;
+            }
         }
 
-        [[nodiscard]] static constexpr auto attribute_descriptions()
-        {
-            constexpr std::array descriptions{
-                VkVertexInputAttributeDescription{.location = 0,
-                    .binding = 0,
-                    .format = VK_FORMAT_R32G32_SFLOAT,
-                    .offset = offsetof(vertex, position)},
-                VkVertexInputAttributeDescription{.location = 1,
-                    .binding = 1,
-                    .format = VK_FORMAT_R32G32_SFLOAT,
-                    .offset = offsetof(instance_data, offset)},
-                VkVertexInputAttributeDescription{.location = 2,
-                    .binding = 1,
-                    .format = VK_FORMAT_R32G32_SFLOAT,
-                    .offset = offsetof(instance_data, dimension)},
-                VkVertexInputAttributeDescription{.location = 3,
-                    .binding = 1,
-                    .format = VK_FORMAT_R32G32B32_SFLOAT,
-                    .offset = offsetof(instance_data, color)},
-            };
-
-            return descriptions;
-        }
-    };
+        particles.emit({.position = to_screen(state.ball_position),
+            .direction = {-state.ball_vector.first, state.ball_vector.second},
+            .speed = 0.1f,
+            .spread = 1.0f,
+            .lifetime = 0.4f,
+            .color = {0.4f, 0.4f, 1.0f},
+            .count = 32});
+    }
 
-    std::vector<vertex> const vertices{{{-1, -1}},
-        {{1, -1}},
-        {{1, 1}},
-        {{-1, 1}}};
+    constexpr float min_sample_shading{.2f};
+
+    constexpr VkPipelineColorBlendAttachmentState additive_blending{
+        .blendEnable = VK_TRUE,
+        .srcColorBlendFactor = VK_BLEND_FACTOR_ONE,
+        .dstColorBlendFactor = VK_BLEND_FACTOR_ONE,
+        .colorBlendOp = VK_BLEND_OP_ADD,
+        .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+        .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+        .alphaBlendOp = VK_BLEND_OP_ADD,
+        .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+            VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT};
+
+    // Quad pipelines with dynamic rasterization samples stay valid when
+    // only the sample count changes.
+    [[nodiscard]] bool quad_pipelines_reusable(
+        vkpong::vulkan_pipeline const& pipeline,
+        vkpong::render_quality const& current,
+        vkpong::render_quality const& next)
+    {
+        return current.sample_shading == next.sample_shading &&
+            current.instance_format == next.instance_format &&
+            current.shader_objects == next.shader_objects &&
+            (current.samples == next.samples ||
+                pipeline.dynamic_states().rasterization_samples);
+    }
 
-    std::vector<uint16_t> const indices{0, 1, 2, 2, 3, 0};
+    [[nodiscard]] vkpong::render_quality default_quality(
+        vkpong::vulkan_device const* const device)
+    {
+        return {.samples = std::min(VK_SAMPLE_COUNT_4_BIT,
+                    device->max_msaa_samples()),
+            .sample_shading = false,
+            .shader_objects = device->shader_objects_supported()};
+    }
 
-    struct [[nodiscard]] uniform_buffer_object final
+    [[nodiscard]] bool supports_upscale(
+        vkpong::vulkan_device const* const device,
+        vkpong::vulkan_render_target const* const target)
     {
-        glm::mat4 model;
-        glm::mat4 view;
-        glm::mat4 projection;
-    };
+        if (!(target->image_usage() & VK_IMAGE_USAGE_TRANSFER_DST_BIT))
+        {
+            return false;
+        }
+
+        VkFormatProperties properties{};
+        vkGetPhysicalDeviceFormatProperties(device->physical(),
+            target->image_format(),
+            &properties);
+
+        constexpr VkFormatFeatureFlags required{
+            VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+            VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT};
+        return (properties.optimalTilingFeatures & required) == required;
+    }
 } // namespace
 
 namespace
@@ -109,8 +199,10 @@ namespace
         pool_info.queueFamilyIndex = device->graphics_family();
 
         VkCommandPool rv{};
-        if (vkCreateCommandPool(device->logical(), &pool_info, nullptr, &rv) !=
-            VK_SUCCESS)
+        if (vkCreateCommandPool(device->logical(),
+                &pool_info,
+                vkpong::allocation_callbacks(),
+                &rv) != VK_SUCCESS)
         {
             throw std::runtime_error{"failed to create command pool"};
         }
@@ -141,12 +233,17 @@ namespace
 
     VkDescriptorPool create_descriptor_pool(vkpong::vulkan_device* const device)
     {
-        constexpr auto count{vkpong::count_cast(
-            vkpong::vulkan_swap_chain::max_frames_in_flight)};
-
         VkDescriptorPoolSize uniform_buffer_pool_size{};
-        uniform_buffer_pool_size.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        uniform_buffer_pool_size.descriptorCount = count;
+        uniform_buffer_pool_size.type =
+            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        uniform_buffer_pool_size.descriptorCount = 1;
+
+        constexpr auto frames{vkpong::count_cast(
+            vkpong::vulkan_render_target::max_frames_in_flight)};
+
+        VkDescriptorPoolSize storage_buffer_pool_size{};
+        storage_buffer_pool_size.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        storage_buffer_pool_size.descriptorCount = frames;
 
         VkDescriptorPoolSize imgui_sampler_pool_size{};
         imgui_sampler_pool_size.type =
@@ -154,6 +251,7 @@ namespace
         imgui_sampler_pool_size.descriptorCount = 1;
 
         std::array pool_sizes{uniform_buffer_pool_size,
+            storage_buffer_pool_size,
             imgui_sampler_pool_size};
 
         VkDescriptorPoolCreateInfo pool_info{};
@@ -161,12 +259,13 @@ namespace
         pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
         pool_info.poolSizeCount = vkpong::count_cast(pool_sizes.size());
         pool_info.pPoolSizes = pool_sizes.data();
-        pool_info.maxSets = count + 1;
+        // Camera set, instance sets of each frame and the ImGui font set.
+        pool_info.maxSets = frames + 2;
 
         VkDescriptorPool rv{};
         if (vkCreateDescriptorPool(device->logical(),
                 &pool_info,
-                nullptr,
+                vkpong::allocation_callbacks(),
                 &rv) != VK_SUCCESS)
         {
             throw std::runtime_error{"failed to create descriptor pool!"};
@@ -175,24 +274,26 @@ namespace
         return rv;
     }
 
+    // Layout of a set with a single buffer read by the vertex shader.
     [[nodiscard]] VkDescriptorSetLayout create_descriptor_set_layout(
-        vkpong::vulkan_device* const device)
+        vkpong::vulkan_device* const device,
+        VkDescriptorType const type)
     {
-        VkDescriptorSetLayoutBinding ubo_layout_binding{};
-        ubo_layout_binding.binding = 0;
-        ubo_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        ubo_layout_binding.descriptorCount = 1;
-        ubo_layout_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = type;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
         VkDescriptorSetLayoutCreateInfo layout_info{};
         layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
         layout_info.bindingCount = 1;
-        layout_info.pBindings = &ubo_layout_binding;
+        layout_info.pBindings = &binding;
 
         VkDescriptorSetLayout rv{};
         if (vkCreateDescriptorSetLayout(device->logical(),
                 &layout_info,
-                nullptr,
+                vkpong::allocation_callbacks(),
                 &rv) != VK_SUCCESS)
         {
             throw std::runtime_error{"failed to create descriptor set layout"};
@@ -201,47 +302,45 @@ namespace
         return rv;
     }
 
-    void create_descriptor_sets(vkpong::vulkan_device* const device,
+    [[nodiscard]] VkDescriptorSet create_descriptor_set(
+        vkpong::vulkan_device* const device,
         VkDescriptorSetLayout const& layout,
-        VkDescriptorPool const& descriptor_pool,
-        std::span<VkDescriptorSet> descriptor_sets)
+        VkDescriptorPool const& descriptor_pool)
     {
-        constexpr auto count{vkpong::count_cast(
-            vkpong::vulkan_swap_chain::max_frames_in_flight)};
-
-        assert(descriptor_sets.size() >= count);
-
-        std::vector<VkDescriptorSetLayout> layouts(count, layout);
-
         VkDescriptorSetAllocateInfo alloc_info{};
         alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         alloc_info.descriptorPool = descriptor_pool;
-        alloc_info.descriptorSetCount = count;
-        alloc_info.pSetLayouts = layouts.data();
+        alloc_info.descriptorSetCount = 1;
+        alloc_info.pSetLayouts = &layout;
 
-        if (vkAllocateDescriptorSets(device->logical(),
-                &alloc_info,
-                descriptor_sets.data()) != VK_SUCCESS)
+        VkDescriptorSet rv{};
+        if (vkAllocateDescriptorSets(device->logical(), &alloc_info, &rv) !=
+            VK_SUCCESS)
         {
             throw std::runtime_error("failed to allocate descriptor sets!");
         }
+
+        return rv;
     }
 
     void bind_descriptor_set(vkpong::vulkan_device* const device,
         VkDescriptorSet const& descriptor_set,
-        VkBuffer const& buffer)
+        uint32_t const binding,
+        VkDescriptorType const type,
+        VkBuffer const& buffer,
+        VkDeviceSize const range = VK_WHOLE_SIZE)
     {
         VkDescriptorBufferInfo buffer_info{};
         buffer_info.buffer = buffer;
         buffer_info.offset = 0;
-        buffer_info.range = VK_WHOLE_SIZE;
+        buffer_info.range = range;
 
         VkWriteDescriptorSet descriptor_write{};
         descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         descriptor_write.dstSet = descriptor_set;
-        descriptor_write.dstBinding = 0;
+        descriptor_write.dstBinding = binding;
         descriptor_write.dstArrayElement = 0;
-        descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        descriptor_write.descriptorType = type;
         descriptor_write.descriptorCount = 1;
         descriptor_write.pBufferInfo = &buffer_info;
 
@@ -255,12 +354,16 @@ namespace
     void transition_image(VkImage const image,
         VkCommandBuffer const command_buffer,
         VkImageLayout const old_layout,
-        VkImageLayout const new_layout)
+        VkImageLayout const new_layout,
+        VkPipelineStageFlags2 const src_stage,
+        VkAccessFlags2 const src_access,
+        VkPipelineStageFlags2 const dst_stage,
+        VkAccessFlags2 const dst_access)
     {
         VkImageMemoryBarrier2 barrier{};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
-        barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE,
-        barrier.srcAccessMask = VK_ACCESS_2_NONE,
+        barrier.srcStageMask = src_stage, barrier.srcAccessMask = src_access,
+        barrier.dstStageMask = dst_stage, barrier.dstAccessMask = dst_access,
         barrier.oldLayout = old_layout, barrier.newLayout = new_layout,
         barrier.image = image,
         barrier.subresourceRange = {
@@ -283,130 +386,259 @@ namespace
 vkpong::vulkan_renderer::vulkan_renderer(GLFWwindow* window,
     vulkan_context* context,
     vulkan_device* device,
-    vulkan_swap_chain* swap_chain)
+    vulkan_render_target* target)
     : window_{window}
     , context_{context}
     , device_{device}
-    , swap_chain_{swap_chain}
+    , target_{target}
+    , quality_{default_quality(device)}
+    , attachments_{device}
     , command_pool_{create_command_pool(device)}
-    , command_buffers_{vulkan_swap_chain::max_frames_in_flight}
-    , vertex_and_index_buffer_{device,
-          sizeof(vertices[0]) * vertices.size() +
-              sizeof(indices[0]) * indices.size(),
-          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-              VK_MEMORY_PROPERTY_HOST_COHERENT_BIT}
-    , descriptor_set_layout_{create_descriptor_set_layout(device)}
+    , command_buffers_{vulkan_render_target::max_frames_in_flight}
+    , uniforms_{device, sizeof(camera_data)}
+    , descriptor_set_layout_{create_descriptor_set_layout(device,
+          VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)}
+    , instance_set_layout_{create_descriptor_set_layout(device,
+          VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)}
     , descriptor_pool_{create_descriptor_pool(device)}
+    , readback_{device}
+    , uploads_{device}
+    , frame_ring_{device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT}
+    , batcher_{&frame_ring_, quality_.instance_format}
+    , text_{device, uploads_}
+    , score_texts_{
+          text_.add_text(npc_score_position, score_size, score_color),
+          text_.add_text(player_score_position, score_size, score_color)}
+    , particles_{device, target->graphics_queue()}
+    , profiler_{device,
+          {"Rectangles",
+              "Circles",
+              "Particle update",
+              "Particles",
+              "Text",
+              "ImGui"}}
 {
-    pipeline_ = std::make_unique<vulkan_pipeline>(
-        vulkan_pipeline_builder{device_, swap_chain_->image_format()}
-            .add_shader(VK_SHADER_STAGE_VERTEX_BIT, "vert.spv", "main")
-            .add_shader(VK_SHADER_STAGE_FRAGMENT_BIT, "frag.spv", "main")
-            .with_rasterization_samples(device_->max_msaa_samples())
-            .add_vertex_input(vertex::binding_description(),
-                vertex::attribute_descriptions())
-            .add_descriptor_set_layout(descriptor_set_layout_)
-            .build());
+    dynamic_resolution_supported_ =
+        profiler_.enabled() && supports_upscale(device_, target_);
 
-    ball_pipeline_ = std::make_unique<vulkan_pipeline>(
-        vulkan_pipeline_builder{device_, swap_chain_->image_format()}
-            .add_shader(VK_SHADER_STAGE_VERTEX_BIT, "vert.spv", "main")
-            .add_shader(VK_SHADER_STAGE_FRAGMENT_BIT, "ball.spv", "main")
-            .with_rasterization_samples(device_->max_msaa_samples())
-            .add_vertex_input(vertex::binding_description(),
-                vertex::attribute_descriptions())
-            .with_push_constants(
-                VkPushConstantRange{.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
-                    .offset = 0,
-                    .size = sizeof(ball_push_consts)})
-            .add_descriptor_set_layout(descriptor_set_layout_)
-            .build());
+    create_pipelines();
 
     recreate_images();
 
     create_command_buffers(device_,
         command_pool_,
-        vulkan_swap_chain::max_frames_in_flight,
+        vulkan_render_target::max_frames_in_flight,
         command_buffers_);
 
-    descriptor_sets_.resize(vulkan_swap_chain::max_frames_in_flight);
-    create_descriptor_sets(device_,
+    descriptor_set_ = create_descriptor_set(device_,
         descriptor_set_layout_,
-        descriptor_pool_,
-        descriptor_sets_);
+        descriptor_pool_);
+    bind_descriptor_set(device_,
+        descriptor_set_,
+        0,
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+        uniforms_.buffer(),
+        uniforms_.slice_size());
 
-    for (size_t i{}; i != size_t{vulkan_swap_chain::max_frames_in_flight}; ++i)
+    for (size_t i{}; i != vulkan_render_target::max_frames_in_flight; ++i)
     {
-        instance_buffers_.emplace_back(device_,
-            sizeof(instance_data) * 3,
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
-
-        auto const& buffer{uniform_buffers_.emplace_back(device_,
-            sizeof(uniform_buffer_object),
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-            true)};
+        instance_sets_[i] = create_descriptor_set(device_,
+            instance_set_layout_,
+            descriptor_pool_);
+        bind_descriptor_set(device_,
+            instance_sets_[i],
+            0,
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            frame_ring_.buffer());
+        bound_instance_buffers_[i] = frame_ring_.buffer();
+    }
 
-        bind_descriptor_set(device_, descriptor_sets_[i], buffer.buffer());
+    // Game coordinates are already in clip space, the camera never changes
+    // and is written once into the first slice of every frame slot.
+    for (uint32_t i{}; i != vulkan_render_target::max_frames_in_flight; ++i)
+    {
+        uniforms_.begin_frame(i);
+        [[maybe_unused]] uint32_t const offset{uniforms_.push(
+            camera_data{.view = glm::mat4{1.0f},
+                .projection = glm::mat4{1.0f}})};
     }
 
-    init_imgui();
+    if (window_)
+    {
+        init_imgui();
+    }
 }
 
 vkpong::vulkan_renderer::~vulkan_renderer()
 {
     vkDeviceWaitIdle(device_->logical());
 
-    ImGui_ImplVulkan_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
-    ImGui::DestroyContext();
+    if (window_)
+    {
+        shutdown_imgui_backend();
+        ImGui_ImplGlfw_Shutdown();
+        ImGui::DestroyContext();
+
+        vkDestroySampler(device_->logical(),
+            imgui_font_sampler_,
+            allocation_callbacks());
+        vkDestroyImageView(device_->logical(),
+            imgui_font_view_,
+            allocation_callbacks());
+        vkDestroyImage(device_->logical(),
+            imgui_font_image_,
+            allocation_callbacks());
+        device_->allocator().free(imgui_font_memory_);
+    }
 
-    vkDestroyDescriptorPool(device_->logical(), descriptor_pool_, nullptr);
+    vkDestroyDescriptorPool(device_->logical(),
+        descriptor_pool_,
+        allocation_callbacks());
+    vkDestroyDescriptorSetLayout(device_->logical(),
+        instance_set_layout_,
+        allocation_callbacks());
     vkDestroyDescriptorSetLayout(device_->logical(),
         descriptor_set_layout_,
-        nullptr);
-
-    uniform_buffers_.clear();
+        allocation_callbacks());
 
-    instance_buffers_.clear();
-
-    vkDestroyCommandPool(device_->logical(), command_pool_, nullptr);
+    vkDestroyCommandPool(device_->logical(),
+        command_pool_,
+        allocation_callbacks());
 
     cleanup_images();
 }
 
 void vkpong::vulkan_renderer::draw(vkpong::game const& state)
 {
+    using clock = std::chrono::steady_clock;
+
+    auto const acquire_start{clock::now()};
     uint32_t image_index{};
-    if (!swap_chain_->acquire_next_image(current_frame_, image_index))
+    if (!target_->acquire_next_image(current_frame_, image_index))
     {
+        batcher_.clear();
         recreate_images();
         return;
     }
 
     auto& command_buffer{command_buffers_[current_frame_]};
-    auto const& descriptor_set{descriptor_sets_[current_frame_]};
 
+    auto const record_start{clock::now()};
     vkResetCommandBuffer(command_buffer, 0);
 
-    record_command_buffer(command_buffer, descriptor_set, image_index);
+    frame_ring_.begin_frame(current_frame_);
+    uniforms_.begin_frame(current_frame_);
+    device_->poll_memory_budget();
+    default_host_allocator().end_frame();
 
-    update_uniform_buffer(uniform_buffers_[current_frame_]);
-    update_instance_buffer(state, instance_buffers_[current_frame_]);
+    submit_entities(state, target_->extent(), batcher_);
+    batcher_.upload();
+    batcher_.clear();
 
-    if (!swap_chain_->submit_command_buffer(&command_buffer,
-            current_frame_,
-            image_index))
+    // The instance set of a frame only changes when the ring buffer was
+    // replaced, the previous use of the set has completed.
+    if (VkBuffer const instances{batcher_.instance_buffer()};
+        instances != VK_NULL_HANDLE &&
+        instances != bound_instance_buffers_[current_frame_])
+    {
+        bind_descriptor_set(device_,
+            instance_sets_[current_frame_],
+            0,
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            instances);
+        bound_instance_buffers_[current_frame_] = instances;
+    }
+
+    // Glyphs are rebuilt only when a score changes.
+    text_.set_text(score_texts_[0], std::to_string(state.npc_score));
+    text_.set_text(score_texts_[1], std::to_string(state.player_score));
+    text_.upload(current_frame_);
+
+    // Game state only changes on ticks, rendering the same tick twice must
+    // not emit again.
+    if (state.tick_count != last_tick_count_)
+    {
+        emit_particles(state, particles_);
+        last_tick_count_ = state.tick_count;
+    }
+
+    // Uploads queued since the last frame are waited on by this one.
+    std::optional<VkSemaphoreSubmitInfo> const upload_wait{uploads_.submit()};
+    std::span<VkSemaphoreSubmitInfo const> wait_semaphores;
+    if (upload_wait)
+    {
+        wait_semaphores = {&*upload_wait, 1};
+    }
+
+    uint32_t const camera_offset{allocate_camera()};
+    record_command_buffer(command_buffer, camera_offset, image_index);
+
+    // Recording writes the particle emitters, flush after it.
+    device_->allocator().flush_pending();
+
+    auto const submit_start{clock::now()};
+    std::optional<VkSemaphoreSubmitInfo> const readback_signal{
+        readback_.pending_signal()};
+    std::span<VkSemaphoreSubmitInfo const> signal_semaphores;
+    if (readback_signal)
+    {
+        signal_semaphores = {&*readback_signal, 1};
+    }
+
+    bool const presented{target_->submit_command_buffer(&command_buffer,
+        current_frame_,
+        image_index,
+        wait_semaphores,
+        signal_semaphores)};
+    readback_.submitted();
+    if (!presented)
     {
         recreate_images();
     }
+    auto const submit_end{clock::now()};
+
+    last_frame_timings_ = {.acquire = record_start - acquire_start,
+        .record = submit_start - record_start,
+        .submit = submit_end - submit_start};
 
     current_frame_ =
-        (current_frame_ + 1) % vulkan_swap_chain::max_frames_in_flight;
+        (current_frame_ + 1) % vulkan_render_target::max_frames_in_flight;
+    ++frame_number_;
+
+    if (pending_quality_)
+    {
+        apply_quality(*pending_quality_);
+        pending_quality_.reset();
+    }
+}
+
+void vkpong::vulkan_renderer::set_quality(render_quality const& quality)
+{
+    render_quality clamped{quality};
+    clamped.samples = std::min(quality.samples, device_->max_msaa_samples());
+    clamped.dynamic_resolution =
+        quality.dynamic_resolution && dynamic_resolution_supported_;
+    clamped.shader_objects =
+        quality.shader_objects && device_->shader_objects_supported();
+    if (clamped != quality_)
+    {
+        pending_quality_ = clamped;
+    }
+    else
+    {
+        pending_quality_.reset();
+    }
+}
+
+bool vkpong::vulkan_renderer::readback_supported() const noexcept
+{
+    return (target_->image_usage() & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) &&
+        is_readback_format(target_->image_format());
+}
+
+bool vkpong::vulkan_renderer::shader_objects_supported() const noexcept
+{
+    return device_->shader_objects_supported();
 }
 
 void vkpong::vulkan_renderer::init_imgui()
@@ -427,12 +659,17 @@ void vkpong::vulkan_renderer::init_imgui()
 
     // Setup Platform/Renderer backends
     ImGui_ImplGlfw_InitForVulkan(window_, true);
+    create_imgui_font();
+    init_imgui_backend();
+}
 
+void vkpong::vulkan_renderer::init_imgui_backend()
+{
     VkPipelineRenderingCreateInfoKHR rendering_create_info{};
     rendering_create_info.sType =
         VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
     rendering_create_info.colorAttachmentCount = 1;
-    VkFormat const format{swap_chain_->image_format()};
+    VkFormat const format{target_->image_format()};
     rendering_create_info.pColorAttachmentFormats = &format;
 
     ImGui_ImplVulkan_InitInfo init_info{};
@@ -440,24 +677,97 @@ void vkpong::vulkan_renderer::init_imgui()
     init_info.PhysicalDevice = device_->physical();
     init_info.Device = device_->logical();
     init_info.QueueFamily = device_->graphics_family();
-    init_info.Queue = swap_chain_->graphics_queue();
+    init_info.Queue = target_->graphics_queue();
     init_info.PipelineCache = VK_NULL_HANDLE;
     init_info.DescriptorPool = descriptor_pool_;
     init_info.RenderPass = VK_NULL_HANDLE;
     init_info.Subpass = 0;
     init_info.MinImageCount = 2;
-    init_info.ImageCount = vulkan_swap_chain::max_frames_in_flight;
-    init_info.MSAASamples = device_->max_msaa_samples();
-    init_info.Allocator = VK_NULL_HANDLE;
+    init_info.ImageCount = vulkan_render_target::max_frames_in_flight;
+    // With dynamic resolution ImGui is drawn after the upscale directly
+    // into the single sampled target image.
+    init_info.MSAASamples = quality_.dynamic_resolution
+        ? VK_SAMPLE_COUNT_1_BIT
+        : quality_.samples;
+    init_info.Allocator = allocation_callbacks();
     init_info.CheckVkResultFn = nullptr;
     init_info.UseDynamicRendering = true;
     init_info.PipelineRenderingCreateInfo = rendering_create_info;
     ImGui_ImplVulkan_Init(&init_info);
+
+    imgui_font_set_ = ImGui_ImplVulkan_AddTexture(imgui_font_sampler_,
+        imgui_font_view_,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    // NOLINTNEXTLINE
+    ImGui::GetIO().Fonts->SetTexID(reinterpret_cast<ImTextureID>(
+        imgui_font_set_));
+}
+
+void vkpong::vulkan_renderer::shutdown_imgui_backend()
+{
+    ImGui_ImplVulkan_RemoveTexture(imgui_font_set_);
+    ImGui::GetIO().Fonts->SetTexID(ImTextureID{});
+    ImGui_ImplVulkan_Shutdown();
+}
+
+void vkpong::vulkan_renderer::create_imgui_font()
+{
+    unsigned char* pixels{};
+    int width{};
+    int height{};
+    ImGui::GetIO().Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    VkExtent2D const extent{static_cast<uint32_t>(width),
+        static_cast<uint32_t>(height)};
+    create_image(device_->allocator(),
+        device_->logical(),
+        extent,
+        1,
+        VK_SAMPLE_COUNT_1_BIT,
+        VK_FORMAT_R8G8B8A8_UNORM,
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        device_local_memory,
+        imgui_font_image_,
+        imgui_font_memory_);
+    imgui_font_view_ = create_image_view(device_->logical(),
+        imgui_font_image_,
+        VK_FORMAT_R8G8B8A8_UNORM,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        1);
+
+    VkSamplerCreateInfo sampler_info{};
+    sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    sampler_info.magFilter = VK_FILTER_LINEAR;
+    sampler_info.minFilter = VK_FILTER_LINEAR;
+    sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    sampler_info.minLod = -1000.0f;
+    sampler_info.maxLod = 1000.0f;
+    sampler_info.maxAnisotropy = 1.0f;
+    if (vkCreateSampler(device_->logical(),
+            &sampler_info,
+            allocation_callbacks(),
+            &imgui_font_sampler_) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to create sampler!"};
+    }
+
+    // The first frame waits on the upload, no queue idle is needed.
+    // NOLINTNEXTLINE
+    std::span const bytes{reinterpret_cast<std::byte const*>(pixels),
+        size_t{extent.width} * extent.height * 4};
+    uploads_.upload(imgui_font_image_,
+        extent,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        bytes);
 }
 
 void vkpong::vulkan_renderer::record_command_buffer(
     VkCommandBuffer& command_buffer,
-    VkDescriptorSet const& descriptor_set,
+    uint32_t const camera_offset,
     uint32_t const image_index)
 {
     VkCommandBufferBeginInfo begin_info{};
@@ -467,71 +777,174 @@ void vkpong::vulkan_renderer::record_command_buffer(
         throw std::runtime_error{"unable to begin command buffer recording!"};
     }
 
-    transition_image(swap_chain_->image(image_index),
-        command_buffer,
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    profiler_.begin_frame(command_buffer, current_frame_);
+    uploads_.record_acquire(command_buffer);
+
+    auto const now{std::chrono::steady_clock::now()};
+    float const particle_step{last_particle_update_
+            ? std::min(std::chrono::duration<float>(
+                           now - *last_particle_update_)
+                           .count(),
+                  max_particle_step)
+            : 0.0f};
+    last_particle_update_ = now;
+
+    profiler_.begin_pass(command_buffer, particle_update_pass);
+    particles_.record_update(command_buffer, current_frame_, particle_step);
+    profiler_.end_pass(command_buffer, particle_update_pass);
+
+    VkExtent2D const extent{target_->extent()};
+    if (quality_.dynamic_resolution)
+    {
+        scaler_.update(profiler_.latest_frame_time());
+        VkExtent2D const render_extent{scaler_.scaled(extent)};
+
+        transition_image(scene_image_.image,
+            command_buffer,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_PIPELINE_STAGE_2_BLIT_BIT,
+            VK_ACCESS_2_NONE,
+            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+
+        begin_rendering(command_buffer,
+            scene_image_.view,
+            render_extent,
+            false);
+        record_scene(command_buffer, camera_offset, render_extent);
+        vkCmdEndRendering(command_buffer);
+
+        record_upscale(command_buffer,
+            target_->image(image_index),
+            render_extent);
+
+        begin_rendering(command_buffer,
+            target_->image_view(image_index),
+            extent,
+            true);
+        record_text(command_buffer, extent);
+        record_imgui(command_buffer);
+        vkCmdEndRendering(command_buffer);
+    }
+    else
+    {
+        transition_image(target_->image(image_index),
+            command_buffer,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_ACCESS_2_NONE,
+            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+
+        begin_rendering(command_buffer,
+            target_->image_view(image_index),
+            extent,
+            false);
+        record_scene(command_buffer, camera_offset, extent);
+        record_text(command_buffer, extent);
+        record_imgui(command_buffer);
+        vkCmdEndRendering(command_buffer);
+    }
 
+    VkImageLayout layout{VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkPipelineStageFlags2 stage{
+        VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT};
+    VkAccessFlags2 access{VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT};
+    if (readback_.wanted() && !readback_supported())
+    {
+        if (!std::exchange(readback_unavailable_logged_, true))
+        {
+            spdlog::warn("Screenshots and capture are unavailable, target "
+                         "images can't be copied from");
+        }
+        readback_.drop_requests();
+    }
+    else if (readback_.wanted())
+    {
+        transition_image(target_->image(image_index),
+            command_buffer,
+            layout,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            stage,
+            access,
+            VK_PIPELINE_STAGE_2_COPY_BIT,
+            VK_ACCESS_2_TRANSFER_READ_BIT);
+        layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        stage = VK_PIPELINE_STAGE_2_COPY_BIT;
+        access = VK_ACCESS_2_NONE;
+
+        readback_.record_copy(command_buffer,
+            target_->image(image_index),
+            target_->extent(),
+            target_->image_format(),
+            frame_number_);
+    }
+
+    if (layout != target_->final_layout())
+    {
+        transition_image(target_->image(image_index),
+            command_buffer,
+            layout,
+            target_->final_layout(),
+            stage,
+            access,
+            VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            VK_ACCESS_2_NONE);
+    }
+
+    if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"unable to end command buffer recording!"};
+    }
+}
+
+void vkpong::vulkan_renderer::begin_rendering(
+    VkCommandBuffer const command_buffer,
+    VkImageView const image_view,
+    VkExtent2D const extent,
+    bool const overlay)
+{
     constexpr VkClearValue clear_value{{{0.0f, 4.0f, 0.0f, 1.0f}}};
+    constexpr VkClearValue overdraw_clear_value{{{0.0f, 0.0f, 0.0f, 1.0f}}};
     VkRenderingAttachmentInfoKHR color_attachment_info{};
     color_attachment_info.sType =
         VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
     color_attachment_info.imageLayout =
         VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-    color_attachment_info.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color_attachment_info.loadOp =
+        overlay ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
     color_attachment_info.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    color_attachment_info.clearValue = clear_value;
-    if (is_multisampled())
+    color_attachment_info.clearValue =
+        overdraw_view_ ? overdraw_clear_value : clear_value;
+    if (!overlay && is_multisampled())
     {
-        color_attachment_info.imageView = color_image_view_;
+        color_attachment_info.imageView = color_image_.view;
         color_attachment_info.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
-        color_attachment_info.resolveImageView =
-            swap_chain_->image_view(image_index);
+        color_attachment_info.resolveImageView = image_view;
         color_attachment_info.resolveImageLayout =
             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
     }
     else
     {
-        color_attachment_info.imageView = swap_chain_->image_view(image_index);
+        color_attachment_info.imageView = image_view;
     }
 
     VkRenderingInfoKHR render_info{};
     render_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
-    render_info.renderArea = {{0, 0}, swap_chain_->extent()};
+    render_info.renderArea = {{0, 0}, extent};
     render_info.layerCount = 1;
     render_info.colorAttachmentCount = 1;
     render_info.pColorAttachments = &color_attachment_info;
 
     vkCmdBeginRendering(command_buffer, &render_info);
+}
 
-    vkCmdBindPipeline(command_buffer,
-        VK_PIPELINE_BIND_POINT_GRAPHICS,
-        pipeline_->pipeline());
-
-    size_t const vertices_size{sizeof(vertices[0]) * vertices.size()};
-    vertex_and_index_buffer_.fill(0, as_bytes(vertices));
-    vertex_and_index_buffer_.fill(vertices_size, as_bytes(indices));
-
-    std::array vertex_buffer{vertex_and_index_buffer_.buffer()};
-    std::array instance_buffer{instance_buffers_[current_frame_].buffer()};
-    std::array const offsets{VkDeviceSize{0}};
-    vkCmdBindVertexBuffers(command_buffer,
-        0,
-        1,
-        vertex_buffer.data(),
-        offsets.data());
-    vkCmdBindVertexBuffers(command_buffer,
-        1,
-        1,
-        instance_buffer.data(),
-        offsets.data());
-
-    vkCmdBindIndexBuffer(command_buffer,
-        vertex_and_index_buffer_.buffer(),
-        vertices_size,
-        VK_INDEX_TYPE_UINT16);
-
-    VkExtent2D const extent{swap_chain_->extent()};
+void vkpong::vulkan_renderer::record_scene(VkCommandBuffer const command_buffer,
+    uint32_t const camera_offset,
+    VkExtent2D const extent)
+{
     VkViewport viewport{};
     viewport.x = 0.0f;
     viewport.y = 0.0f;
@@ -539,134 +952,271 @@ void vkpong::vulkan_renderer::record_command_buffer(
     viewport.height = static_cast<float>(extent.height);
     viewport.minDepth = 0.0f;
     viewport.maxDepth = 1.0f;
-    vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+    vkCmdSetViewportWithCount(command_buffer, 1, &viewport);
 
     VkRect2D scissor{};
     scissor.offset = {0, 0};
     scissor.extent = extent;
-    vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+    vkCmdSetScissorWithCount(command_buffer, 1, &scissor);
 
+    // All pipelines share the same layout, the descriptor set stays bound
+    // across pipeline changes.
     vkCmdBindDescriptorSets(command_buffer,
         VK_PIPELINE_BIND_POINT_GRAPHICS,
-        pipeline_->pipeline_layout(),
+        overdraw_pipeline_->pipeline_layout(),
         0,
         1,
-        &descriptor_set,
+        &descriptor_set_,
+        1,
+        &camera_offset);
+    vkCmdBindDescriptorSets(command_buffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        overdraw_pipeline_->pipeline_layout(),
+        1,
+        1,
+        &instance_sets_[current_frame_],
         0,
         nullptr);
 
-    vkCmdDrawIndexed(command_buffer, count_cast(indices.size()), 2, 0, 0, 0);
+    pipeline_state state{.rasterization_samples = quality_.samples};
+    if (overdraw_view_)
+    {
+        state.color_blending = additive_blending;
+    }
 
-    vkCmdBindPipeline(command_buffer,
-        VK_PIPELINE_BIND_POINT_GRAPHICS,
-        ball_pipeline_->pipeline());
-    vkCmdSetViewport(command_buffer, 0, 1, &viewport);
-    vkCmdSetScissor(command_buffer, 0, 1, &scissor);
-
-    ball_push_consts ball_push_values{
-        .resolution = {extent.width, extent.height}};
-    ball_push_values.color[0].r = 0.5f;
-    ball_push_values.color[1].g = 0.5f;
-    ball_push_values.color[2].b = 0.5f;
-    ball_push_values.color[3].r = 0.5f;
-    ball_push_values.color[4].g = 0.5f;
-    ball_push_values.color[5].b = 0.5f;
-
-    vkCmdPushConstants(command_buffer,
-        ball_pipeline_->pipeline_layout(),
-        VK_SHADER_STAGE_FRAGMENT_BIT,
-        0,
-        sizeof(ball_push_consts),
-        &ball_push_values);
+    for (quad_batch const& batch : batcher_.batches())
+    {
+        vulkan_pipeline const& pipeline{overdraw_view_
+                ? *overdraw_pipeline_
+                : *shape_pipelines_[static_cast<size_t>(batch.shape)]};
+        size_t const pass{static_cast<size_t>(batch.shape)};
+
+        profiler_.begin_pass(command_buffer, pass);
+        pipeline.bind(command_buffer, state);
+        vkCmdDraw(command_buffer,
+            quad_vertex_count,
+            batch.instance_count,
+            0,
+            batch.first_instance);
+        profiler_.end_pass(command_buffer, pass);
+    }
 
-    vkCmdDrawIndexed(command_buffer, count_cast(indices.size()), 1, 0, 0, 2);
+    profiler_.begin_pass(command_buffer, particle_pass);
+    particles_.draw(command_buffer, current_frame_, extent);
+    profiler_.end_pass(command_buffer, particle_pass);
+}
 
-    ImGui::Render();
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), command_buffer);
+void vkpong::vulkan_renderer::record_text(VkCommandBuffer const command_buffer,
+    VkExtent2D const extent)
+{
+    profiler_.begin_pass(command_buffer, text_pass);
+    text_.draw(command_buffer, current_frame_, extent);
+    profiler_.end_pass(command_buffer, text_pass);
+}
 
-    vkCmdEndRendering(command_buffer);
+void vkpong::vulkan_renderer::record_imgui(VkCommandBuffer const command_buffer)
+{
+    if (window_)
+    {
+        profiler_.begin_pass(command_buffer, imgui_pass);
+        ImGui::Render();
+        ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), command_buffer);
+        profiler_.end_pass(command_buffer, imgui_pass);
+    }
+}
 
-    transition_image(swap_chain_->image(image_index),
+void vkpong::vulkan_renderer::record_upscale(
+    VkCommandBuffer const command_buffer,
+    VkImage const target_image,
+    VkExtent2D const render_extent)
+{
+    transition_image(scene_image_.image,
         command_buffer,
         VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_BLIT_BIT,
+        VK_ACCESS_2_TRANSFER_READ_BIT);
 
-    if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS)
-    {
-        throw std::runtime_error{"unable to end command buffer recording!"};
-    }
+    transition_image(target_image,
+        command_buffer,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_ACCESS_2_NONE,
+        VK_PIPELINE_STAGE_2_BLIT_BIT,
+        VK_ACCESS_2_TRANSFER_WRITE_BIT);
+
+    VkExtent2D const extent{target_->extent()};
+    VkImageBlit region{};
+    region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.srcSubresource.layerCount = 1;
+    region.srcOffsets[1] = {static_cast<int32_t>(render_extent.width),
+        static_cast<int32_t>(render_extent.height),
+        1};
+    region.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.dstSubresource.layerCount = 1;
+    region.dstOffsets[1] = {static_cast<int32_t>(extent.width),
+        static_cast<int32_t>(extent.height),
+        1};
+    vkCmdBlitImage(command_buffer,
+        scene_image_.image,
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        target_image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1,
+        &region,
+        VK_FILTER_LINEAR);
+
+    transition_image(target_image,
+        command_buffer,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        VK_PIPELINE_STAGE_2_BLIT_BIT,
+        VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT |
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
 }
 
-void vkpong::vulkan_renderer::update_uniform_buffer(
-    vkpong::vulkan_buffer& buffer)
+void vkpong::vulkan_renderer::create_pipelines()
 {
-    uniform_buffer_object ubo{};
-    ubo.model = glm::mat4{1.0f};
+    create_quad_pipelines();
+    create_effect_pipelines();
+}
+
+void vkpong::vulkan_renderer::create_quad_pipelines()
+{
+    auto const build_start{std::chrono::steady_clock::now()};
+
+    auto const configure = [this](vulkan_pipeline_builder& builder)
+        -> vulkan_pipeline_builder&
+    {
+        builder.with_rasterization_samples(quality_.samples)
+            .with_extended_dynamic_state()
+            .add_descriptor_set_layout(descriptor_set_layout_)
+            .add_descriptor_set_layout(instance_set_layout_)
+            .add_specialization_constant(VK_SHADER_STAGE_VERTEX_BIT,
+                packed_instances_constant,
+                quality_.instance_format == quad_instance_format::packed
+                    ? VK_TRUE
+                    : VK_FALSE);
+        if (quality_.sample_shading)
+        {
+            builder.with_sample_shading(min_sample_shading);
+        }
+        if (quality_.shader_objects)
+        {
+            builder.with_shader_objects();
+        }
+        return builder;
+    };
 
-    ubo.view = glm::mat4{1.0f};
+    vulkan_pipeline_builder rectangle_builder{device_,
+        target_->image_format()};
+    configure(rectangle_builder)
+        .add_shader(VK_SHADER_STAGE_VERTEX_BIT, "vert.spv", "main")
+        .add_shader(VK_SHADER_STAGE_FRAGMENT_BIT, "frag.spv", "main");
+    shape_pipelines_[static_cast<size_t>(quad_shape::rectangle)] =
+        std::make_unique<vulkan_pipeline>(rectangle_builder.build());
+
+    vulkan_pipeline_builder circle_builder{device_, target_->image_format()};
+    configure(circle_builder)
+        .add_shader(VK_SHADER_STAGE_VERTEX_BIT, "vert.spv", "main")
+        .add_shader(VK_SHADER_STAGE_FRAGMENT_BIT, "ball.spv", "main");
+    shape_pipelines_[static_cast<size_t>(quad_shape::circle)] =
+        std::make_unique<vulkan_pipeline>(circle_builder.build());
+
+    vulkan_pipeline_builder overdraw_builder{device_, target_->image_format()};
+    overdraw_pipeline_ = std::make_unique<vulkan_pipeline>(
+        configure(overdraw_builder)
+            .add_shader(VK_SHADER_STAGE_VERTEX_BIT, "vert.spv", "main")
+            .add_shader(VK_SHADER_STAGE_FRAGMENT_BIT, "overdraw.spv", "main")
+            .with_color_blending(additive_blending)
+            .build());
 
-    ubo.projection[0][0] = glm::radians(110.f);
-    ubo.projection[1][1] = -1;
-    ubo.projection[2][2] = 1;
-    ubo.projection[3][3] = 1;
+    quad_pipeline_build_time_ = std::chrono::steady_clock::now() - build_start;
+}
 
-    buffer.fill(0, as_bytes(ubo));
+void vkpong::vulkan_renderer::create_effect_pipelines()
+{
+    particles_.create_pipeline(target_->image_format(),
+        quality_.samples,
+        quality_.shader_objects);
+
+    // Text is drawn in the same pass as ImGui.
+    text_.create_pipeline(target_->image_format(),
+        quality_.dynamic_resolution ? VK_SAMPLE_COUNT_1_BIT : quality_.samples,
+        quality_.shader_objects);
 }
 
-void vkpong::vulkan_renderer::update_instance_buffer(vkpong::game const& state,
-    vkpong::vulkan_buffer& buffer)
+uint32_t vkpong::vulkan_renderer::allocate_camera()
 {
-    std::array data{
-        instance_data{.offset = glm::vec2(-.9f, state.player_position),
-            .dimension = glm::vec2(0.02f, 0.2f),
-            .color = glm::vec3(.5f, 0, 0)},
-        instance_data{.offset = glm::vec2(.9f, state.npc_position),
-            .dimension = glm::vec2(0.02f, 0.2f),
-            .color = glm::vec3(0, .5f, 0)},
-        instance_data{.offset = glm::vec2(state.ball_position.first,
-                          -state.ball_position.second),
-            .dimension = glm::vec2(2, 2),
-            .color = glm::vec3(0, 0, .5f)}};
-
-    buffer.fill(0, as_bytes(data));
+    // The camera is the first slice of a frame, it keeps the value written
+    // at construction.
+    return uniforms_.allocate();
+}
+
+void vkpong::vulkan_renderer::apply_quality(render_quality const& quality)
+{
+    vkDeviceWaitIdle(device_->logical());
+
+    bool const reuse_quad_pipelines{
+        quad_pipelines_reusable(*overdraw_pipeline_, quality_, quality)};
+
+    quality_ = quality;
+    batcher_.set_format(quality_.instance_format);
+
+    if (!reuse_quad_pipelines)
+    {
+        create_quad_pipelines();
+    }
+    create_effect_pipelines();
+    recreate_images();
+
+    if (window_)
+    {
+        shutdown_imgui_backend();
+        init_imgui_backend();
+    }
+
+    profiler_.reset();
+    scaler_.reset();
 }
 
 bool vkpong::vulkan_renderer::is_multisampled() const
 {
-    return device_->max_msaa_samples() != VK_SAMPLE_COUNT_1_BIT;
+    return quality_.samples != VK_SAMPLE_COUNT_1_BIT;
 }
 
 void vkpong::vulkan_renderer::recreate_images()
 {
+    cleanup_images();
+
     if (is_multisampled())
     {
-        cleanup_images();
+        color_image_ = attachments_.acquire({.format = target_->image_format(),
+            .extent = target_->extent(),
+            .samples = quality_.samples,
+            .usage = VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT});
+    }
 
-        // color image
-        create_image(device_->physical(),
-            device_->logical(),
-            swap_chain_->extent(),
-            1,
-            device_->max_msaa_samples(),
-            swap_chain_->image_format(),
-            VK_IMAGE_TILING_OPTIMAL,
-            VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
-                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            color_image_,
-            color_image_memory_);
-
-        color_image_view_ = create_image_view(device_->logical(),
-            color_image_,
-            swap_chain_->image_format(),
-            VK_IMAGE_ASPECT_COLOR_BIT,
-            1);
+    if (quality_.dynamic_resolution)
+    {
+        // Acquired at the full extent, the scale only changes the render
+        // area within it.
+        scene_image_ = attachments_.acquire({.format = target_->image_format(),
+            .extent = target_->extent(),
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                VK_IMAGE_USAGE_TRANSFER_SRC_BIT});
     }
 }
 
 void vkpong::vulkan_renderer::cleanup_images()
 {
-    vkDestroyImageView(device_->logical(), color_image_view_, nullptr);
-    vkDestroyImage(device_->logical(), color_image_, nullptr);
-    vkFreeMemory(device_->logical(), color_image_memory_, nullptr);
+    attachments_.release(color_image_);
+    attachments_.release(scene_image_);
 }
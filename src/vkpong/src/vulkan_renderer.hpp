@@ -1,12 +1,30 @@
 #ifndef VKPONG_VULKAN_RENDERER_INCLUDED
 #define VKPONG_VULKAN_RENDERER_INCLUDED
 
-#include <vulkan_buffer.hpp>
+#include <device_allocator.hpp>
+#include <dynamic_uniform_buffer.hpp>
+#include <frame_readback.hpp>
+#include <gpu_layout.hpp>
+#include <particle_system.hpp>
+#include <quad_batcher.hpp>
+#include <render_target_pool.hpp>
+#include <resolution_scaler.hpp>
+#include <ring_allocator.hpp>
+#include <text_renderer.hpp>
+#include <upload_manager.hpp>
+#include <vulkan_profiler.hpp>
+#include <vulkan_render_target.hpp>
+
+#include <glm/glm.hpp>
 
 #include <vulkan/vulkan_core.h>
 
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <vector>
 
 struct GLFWwindow;
@@ -17,19 +35,43 @@ namespace vkpong
 
     class vulkan_context;
     class vulkan_device;
-    class vulkan_swap_chain;
     class vulkan_pipeline;
 } // namespace vkpong
 
 namespace vkpong
 {
+    struct [[nodiscard]] frame_timings final
+    {
+        std::chrono::nanoseconds acquire{};
+        std::chrono::nanoseconds record{};
+        std::chrono::nanoseconds submit{};
+    };
+
+    struct [[nodiscard]] render_quality final
+    {
+        VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+        bool sample_shading{};
+        bool dynamic_resolution{};
+        quad_instance_format instance_format{quad_instance_format::full};
+        // Falls back to pipelines without device support.
+        bool shader_objects{};
+
+        bool operator==(render_quality const&) const = default;
+    };
+
+    // Selectable render_quality::samples, in increasing order.
+    inline constexpr std::array msaa_sample_counts{VK_SAMPLE_COUNT_1_BIT,
+        VK_SAMPLE_COUNT_2_BIT,
+        VK_SAMPLE_COUNT_4_BIT,
+        VK_SAMPLE_COUNT_8_BIT};
+
     class [[nodiscard]] vulkan_renderer final
     {
     public: // Construction
-        vulkan_renderer(GLFWwindow* windiw,
+        vulkan_renderer(GLFWwindow* window,
             vulkan_context* context,
             vulkan_device* device,
-            vulkan_swap_chain* swap_chain);
+            vulkan_render_target* target);
 
         vulkan_renderer(vulkan_renderer const&) = delete;
 
@@ -41,21 +83,110 @@ namespace vkpong
     public: // Interface
         void draw(game const& state);
 
+        [[nodiscard]] constexpr frame_timings const&
+        last_frame_timings() const noexcept;
+
+        [[nodiscard]] constexpr frame_readback& readback() noexcept;
+
+        // Screenshots and captures need a transfer source target with 4
+        // byte texels.
+        [[nodiscard]] bool readback_supported() const noexcept;
+
+        // Quads added before draw are rendered together with the game.
+        [[nodiscard]] constexpr quad_batcher& batcher() noexcept;
+
+        // HUD strings drawn on top of the scene at the full target extent.
+        [[nodiscard]] constexpr text_renderer& text() noexcept;
+
+        [[nodiscard]] constexpr particle_system& particles() noexcept;
+
+        [[nodiscard]] constexpr vulkan_profiler& profiler() noexcept;
+
+        [[nodiscard]] constexpr vulkan_profiler const&
+        profiler() const noexcept;
+
+        [[nodiscard]] constexpr bool overdraw_view() const noexcept;
+
+        [[nodiscard]] constexpr render_quality const& quality() const noexcept;
+
+        // Applied after the current frame is submitted, pipelines and the
+        // multisampled color image are recreated.
+        void set_quality(render_quality const& quality);
+
+        constexpr void set_overdraw_view(bool enabled) noexcept;
+
+        [[nodiscard]] constexpr bool
+        dynamic_resolution_supported() const noexcept;
+
+        [[nodiscard]] bool shader_objects_supported() const noexcept;
+
+        [[nodiscard]] constexpr resolution_scaler& scaler() noexcept;
+
+        [[nodiscard]] constexpr resolution_scaler const&
+        scaler() const noexcept;
+
+        // Time spent creating the quad pipelines or shader objects when
+        // they were last built.
+        [[nodiscard]] constexpr std::chrono::nanoseconds
+        quad_pipeline_build_time() const noexcept;
+
     public: // Operators
         vulkan_renderer& operator=(vulkan_renderer const&) = delete;
 
         vulkan_renderer& operator=(vulkan_renderer&&) noexcept = delete;
 
+    private: // Types
+        struct [[nodiscard]] camera_data final
+        {
+            glm::mat4 view;
+            glm::mat4 projection;
+        };
+
+        // Camera block of shader.vert.
+        static_assert(std140_layout<camera_data>);
+        static_assert(
+            gpu_aligned<glm::mat4>(offsetof(camera_data, projection)));
+
     private: // Helpers
         void init_imgui();
 
+        void init_imgui_backend();
+
+        void shutdown_imgui_backend();
+
+        void create_imgui_font();
+
+        void create_pipelines();
+
+        void create_quad_pipelines();
+
+        void create_effect_pipelines();
+
+        void apply_quality(render_quality const& quality);
+
         void record_command_buffer(VkCommandBuffer& command_buffer,
-            VkDescriptorSet const& descriptor_set,
+            uint32_t camera_offset,
             uint32_t image_index);
 
-        void update_uniform_buffer(vulkan_buffer& buffer);
+        void begin_rendering(VkCommandBuffer command_buffer,
+            VkImageView image_view,
+            VkExtent2D extent,
+            bool overlay);
 
-        void update_instance_buffer(game const& state, vulkan_buffer& buffer);
+        void record_scene(VkCommandBuffer command_buffer,
+            uint32_t camera_offset,
+            VkExtent2D extent);
+
+        void record_text(VkCommandBuffer command_buffer, VkExtent2D extent);
+
+        void record_imgui(VkCommandBuffer command_buffer);
+
+        void record_upscale(VkCommandBuffer command_buffer,
+            VkImage target_image,
+            VkExtent2D render_extent);
+
+        // Returns the dynamic offset of the camera uniforms.
+        [[nodiscard]] uint32_t allocate_camera();
 
         [[nodiscard]] bool is_multisampled() const;
 
@@ -67,28 +198,147 @@ namespace vkpong
         GLFWwindow* window_;
         vulkan_context* context_;
         vulkan_device* device_;
-        vulkan_swap_chain* swap_chain_;
+        vulkan_render_target* target_;
+
+        std::array<std::unique_ptr<vulkan_pipeline>, quad_shape_count>
+            shape_pipelines_;
+        std::unique_ptr<vulkan_pipeline> overdraw_pipeline_;
+        bool overdraw_view_{};
+        render_quality quality_;
+        std::optional<render_quality> pending_quality_;
 
-        std::unique_ptr<vulkan_pipeline> pipeline_;
-        std::unique_ptr<vulkan_pipeline> ball_pipeline_;
+        render_target_pool attachments_;
+        pooled_attachment color_image_;
 
-        VkImage color_image_{};
-        VkDeviceMemory color_image_memory_{};
-        VkImageView color_image_view_{};
+        bool dynamic_resolution_supported_{};
+        resolution_scaler scaler_;
+        pooled_attachment scene_image_;
 
         VkCommandPool command_pool_{};
         std::vector<VkCommandBuffer> command_buffers_{};
 
-        vulkan_buffer vertex_and_index_buffer_;
-        std::vector<vulkan_buffer> instance_buffers_;
-        std::vector<vulkan_buffer> uniform_buffers_;
+        dynamic_uniform_buffer uniforms_;
 
         VkDescriptorSetLayout descriptor_set_layout_{};
+        VkDescriptorSetLayout instance_set_layout_{};
         VkDescriptorPool descriptor_pool_{};
-        std::vector<VkDescriptorSet> descriptor_sets_;
+        VkDescriptorSet descriptor_set_{};
+        // Instance streams are bound per frame, the ring buffer can be
+        // replaced while other frames still use the previous one.
+        std::array<VkDescriptorSet, vulkan_render_target::max_frames_in_flight>
+            instance_sets_{};
 
         uint32_t current_frame_{};
+        uint64_t frame_number_{};
+
+        frame_timings last_frame_timings_;
+        std::chrono::nanoseconds quad_pipeline_build_time_{};
+
+        frame_readback readback_;
+        bool readback_unavailable_logged_{};
+        upload_manager uploads_;
+        // Uploaded through the upload manager instead of the blocking
+        // upload of the ImGui backend.
+        VkImage imgui_font_image_{};
+        device_allocation imgui_font_memory_;
+        VkImageView imgui_font_view_{};
+        VkSampler imgui_font_sampler_{};
+        VkDescriptorSet imgui_font_set_{};
+        ring_allocator frame_ring_;
+        quad_batcher batcher_;
+        std::array<VkBuffer, vulkan_render_target::max_frames_in_flight>
+            bound_instance_buffers_{};
+        text_renderer text_;
+        std::array<size_t, 2> score_texts_{};
+        particle_system particles_;
+        uint64_t last_tick_count_{};
+        std::optional<std::chrono::steady_clock::time_point>
+            last_particle_update_;
+        vulkan_profiler profiler_;
     };
 } // namespace vkpong
 
+inline constexpr vkpong::frame_timings const&
+vkpong::vulkan_renderer::last_frame_timings() const noexcept
+{
+    return last_frame_timings_;
+}
+
+inline constexpr vkpong::frame_readback&
+vkpong::vulkan_renderer::readback() noexcept
+{
+    return readback_;
+}
+
+inline constexpr vkpong::quad_batcher&
+vkpong::vulkan_renderer::batcher() noexcept
+{
+    return batcher_;
+}
+
+inline constexpr vkpong::text_renderer&
+vkpong::vulkan_renderer::text() noexcept
+{
+    return text_;
+}
+
+inline constexpr vkpong::particle_system&
+vkpong::vulkan_renderer::particles() noexcept
+{
+    return particles_;
+}
+
+inline constexpr vkpong::vulkan_profiler&
+vkpong::vulkan_renderer::profiler() noexcept
+{
+    return profiler_;
+}
+
+inline constexpr vkpong::vulkan_profiler const&
+vkpong::vulkan_renderer::profiler() const noexcept
+{
+    return profiler_;
+}
+
+inline constexpr bool vkpong::vulkan_renderer::overdraw_view() const noexcept
+{
+    return overdraw_view_;
+}
+
+inline constexpr vkpong::render_quality const&
+vkpong::vulkan_renderer::quality() const noexcept
+{
+    return quality_;
+}
+
+inline constexpr void vkpong::vulkan_renderer::set_overdraw_view(
+    bool const enabled) noexcept
+{
+    overdraw_view_ = enabled;
+}
+
+inline constexpr bool
+vkpong::vulkan_renderer::dynamic_resolution_supported() const noexcept
+{
+    return dynamic_resolution_supported_;
+}
+
+inline constexpr vkpong::resolution_scaler&
+vkpong::vulkan_renderer::scaler() noexcept
+{
+    return scaler_;
+}
+
+inline constexpr vkpong::resolution_scaler const&
+vkpong::vulkan_renderer::scaler() const noexcept
+{
+    return scaler_;
+}
+
+inline constexpr std::chrono::nanoseconds
+vkpong::vulkan_renderer::quad_pipeline_build_time() const noexcept
+{
+    return quad_pipeline_build_time_;
+}
+
 #endif // !VKPONG_VULKAN_RENDERER_INCLUDED
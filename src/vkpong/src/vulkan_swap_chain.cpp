@@ -1,5 +1,6 @@
 #include <vulkan_swap_chain.hpp>
 
+#include <host_allocator.hpp>
 #include <vulkan_context.hpp>
 #include <vulkan_device.hpp>
 #include <vulkan_utility.hpp>
@@ -8,6 +9,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -70,44 +72,6 @@ namespace
 
         return actual_extent;
     }
-
-    [[nodiscard]] VkSemaphore create_semaphore(
-        vkpong::vulkan_device* const device)
-    {
-        VkSemaphoreCreateInfo semaphore_info{};
-        semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-
-        VkSemaphore rv{};
-        if (vkCreateSemaphore(device->logical(),
-                &semaphore_info,
-                nullptr,
-                &rv) != VK_SUCCESS)
-        {
-            throw std::runtime_error{"failed to create semaphore"};
-        }
-
-        return rv;
-    }
-
-    [[nodiscard]] VkFence create_fence(vkpong::vulkan_device* const device,
-        bool set_signaled)
-    {
-        VkFenceCreateInfo fence_info{};
-        fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        if (set_signaled)
-        {
-            fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-        }
-
-        VkFence rv{};
-        if (vkCreateFence(device->logical(), &fence_info, nullptr, &rv) !=
-            VK_SUCCESS)
-        {
-            throw std::runtime_error{"failed to create fence"};
-        }
-
-        return rv;
-    }
 } // namespace
 
 vkpong::swap_chain_support
@@ -179,6 +143,7 @@ vkpong::vulkan_swap_chain::vulkan_swap_chain(vulkan_swap_chain&& other) noexcept
     , context_{other.context_}
     , device_{std::exchange(other.device_, nullptr)}
     , image_format_{other.image_format_}
+    , image_usage_{other.image_usage_}
     , extent_{other.extent_}
     , chain{std::exchange(other.chain, nullptr)}
     , images_{std::move(other.images_)}
@@ -234,26 +199,49 @@ bool vkpong::vulkan_swap_chain::acquire_next_image(uint32_t const current_frame,
 bool vkpong::vulkan_swap_chain::submit_command_buffer(
     VkCommandBuffer const* const command_buffer,
     uint32_t const current_frame,
-    uint32_t const image_index)
+    uint32_t const image_index,
+    std::span<VkSemaphoreSubmitInfo const> const wait_semaphores,
+    std::span<VkSemaphoreSubmitInfo const> const signal_semaphores)
 {
     auto const& sync{image_syncs_[current_frame]};
 
-    std::array const wait_semaphores{sync.image_available};
-    std::array<VkPipelineStageFlags, 1> const wait_stages{
-        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    std::array const signal_semaphores{sync.render_finished};
-
-    VkSubmitInfo submit_info{};
-    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submit_info.waitSemaphoreCount = 1;
-    submit_info.pWaitSemaphores = wait_semaphores.data();
-    submit_info.pWaitDstStageMask = wait_stages.data();
-    submit_info.commandBufferCount = 1;
-    submit_info.pCommandBuffers = command_buffer;
-    submit_info.signalSemaphoreCount = 1;
-    submit_info.pSignalSemaphores = signal_semaphores.data();
-
-    if (vkQueueSubmit(graphics_queue_, 1, &submit_info, sync.in_flight) !=
+    assert(wait_semaphores.size() <= max_submit_semaphores);
+    assert(signal_semaphores.size() <= max_submit_semaphores);
+
+    std::array<VkSemaphoreSubmitInfo, max_submit_semaphores + 1>
+        wait_semaphore_infos{};
+    std::ranges::copy(wait_semaphores, wait_semaphore_infos.begin());
+    VkSemaphoreSubmitInfo& image_available_info{
+        wait_semaphore_infos[wait_semaphores.size()]};
+    image_available_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    image_available_info.semaphore = sync.image_available;
+    image_available_info.stageMask =
+        VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+    std::array<VkSemaphoreSubmitInfo, max_submit_semaphores + 1>
+        signal_semaphore_infos{};
+    std::ranges::copy(signal_semaphores, signal_semaphore_infos.begin());
+    VkSemaphoreSubmitInfo& render_finished_info{
+        signal_semaphore_infos[signal_semaphores.size()]};
+    render_finished_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+    render_finished_info.semaphore = sync.render_finished;
+    render_finished_info.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+    VkCommandBufferSubmitInfo command_buffer_info{};
+    command_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+    command_buffer_info.commandBuffer = *command_buffer;
+
+    VkSubmitInfo2 submit_info{};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+    submit_info.waitSemaphoreInfoCount = count_cast(wait_semaphores.size() + 1);
+    submit_info.pWaitSemaphoreInfos = wait_semaphore_infos.data();
+    submit_info.commandBufferInfoCount = 1;
+    submit_info.pCommandBufferInfos = &command_buffer_info;
+    submit_info.signalSemaphoreInfoCount =
+        count_cast(signal_semaphores.size() + 1);
+    submit_info.pSignalSemaphoreInfos = signal_semaphore_infos.data();
+
+    if (vkQueueSubmit2(graphics_queue_, 1, &submit_info, sync.in_flight) !=
         VK_SUCCESS)
     {
         throw std::runtime_error("failed to submit draw command buffer!");
@@ -263,7 +251,7 @@ bool vkpong::vulkan_swap_chain::submit_command_buffer(
     VkPresentInfoKHR present_info{};
     present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     present_info.waitSemaphoreCount = 1;
-    present_info.pWaitSemaphores = signal_semaphores.data();
+    present_info.pWaitSemaphores = &sync.render_finished;
     present_info.swapchainCount = 1;
     present_info.pSwapchains = swapchains.data();
     present_info.pImageIndices = &image_index;
@@ -311,6 +299,7 @@ vkpong::vulkan_swap_chain& vkpong::vulkan_swap_chain::operator=(
         swap(context_, other.context_);
         swap(device_, other.device_);
         swap(image_format_, other.image_format_);
+        swap(image_usage_, other.image_usage_);
         swap(extent_, other.extent_);
         swap(chain, other.chain);
         swap(images_, other.images_);
@@ -351,7 +340,11 @@ void vkpong::vulkan_swap_chain::create_chain_and_images()
     create_info.imageColorSpace = surface_format.colorSpace;
     create_info.imageExtent = extent_;
     create_info.imageArrayLayers = 1;
-    create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    image_usage_ = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+        (swap_details.capabilities.supportedUsageFlags &
+            (VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                VK_IMAGE_USAGE_TRANSFER_DST_BIT));
+    create_info.imageUsage = image_usage_;
     create_info.preTransform = swap_details.capabilities.currentTransform;
     create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     create_info.presentMode = present_mode;
@@ -375,7 +368,7 @@ void vkpong::vulkan_swap_chain::create_chain_and_images()
 
     if (vkCreateSwapchainKHR(device_->logical(),
             &create_info,
-            nullptr,
+            allocation_callbacks(),
             &chain) != VK_SUCCESS)
     {
         throw std::runtime_error{"failed to create swap chain!"};
@@ -413,18 +406,20 @@ void vkpong::vulkan_swap_chain::cleanup()
 {
     for (size_t i{}; i != images_.size(); ++i)
     {
-        vkDestroyImageView(device_->logical(), image_views_[i], nullptr);
+        vkDestroyImageView(device_->logical(),
+            image_views_[i],
+            allocation_callbacks());
     }
 
-    vkDestroySwapchainKHR(device_->logical(), chain, nullptr);
+    vkDestroySwapchainKHR(device_->logical(), chain, allocation_callbacks());
 }
 
 vkpong::vulkan_swap_chain::image_sync::image_sync(
     vkpong::vulkan_device* const device)
     : device_{device}
-    , image_available(create_semaphore(device))
-    , render_finished(create_semaphore(device))
-    , in_flight(create_fence(device, true))
+    , image_available(create_semaphore(device->logical()))
+    , render_finished(create_semaphore(device->logical()))
+    , in_flight(create_fence(device->logical(), true))
 {
 }
 
@@ -440,8 +435,12 @@ vkpong::vulkan_swap_chain::image_sync::~image_sync()
 {
     if (device_)
     {
-        vkDestroyFence(device_->logical(), in_flight, nullptr);
-        vkDestroySemaphore(device_->logical(), render_finished, nullptr);
-        vkDestroySemaphore(device_->logical(), image_available, nullptr);
+        vkDestroyFence(device_->logical(), in_flight, allocation_callbacks());
+        vkDestroySemaphore(device_->logical(),
+            render_finished,
+            allocation_callbacks());
+        vkDestroySemaphore(device_->logical(),
+            image_available,
+            allocation_callbacks());
     }
 }
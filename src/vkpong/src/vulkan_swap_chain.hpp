@@ -1,9 +1,12 @@
 #ifndef VKPONG_VULKAN_SWAP_CHAIN_INCLUDED
 #define VKPONG_VULKAN_SWAP_CHAIN_INCLUDED
 
+#include <vulkan_render_target.hpp>
+
 #include <vulkan/vulkan_core.h>
 
 #include <cstdint>
+#include <span>
 #include <vector>
 
 struct GLFWwindow;
@@ -26,11 +29,8 @@ namespace vkpong
     swap_chain_support query_swap_chain_support(VkPhysicalDevice device,
         VkSurfaceKHR surface);
 
-    class [[nodiscard]] vulkan_swap_chain final
+    class [[nodiscard]] vulkan_swap_chain final : public vulkan_render_target
     {
-    public: // Constants
-        static constexpr int max_frames_in_flight{2};
-
     public: // Construction
         vulkan_swap_chain(GLFWwindow* window,
             vulkan_context* context,
@@ -41,28 +41,35 @@ namespace vkpong
         vulkan_swap_chain(vulkan_swap_chain&& other) noexcept;
 
     public: // Destruction
-        ~vulkan_swap_chain();
+        ~vulkan_swap_chain() override;
 
     public: // Interface
-        [[nodiscard]] constexpr VkExtent2D extent() const noexcept;
+        [[nodiscard]] VkExtent2D extent() const noexcept override;
+
+        [[nodiscard]] VkQueue graphics_queue() const noexcept override;
 
-        [[nodiscard]] constexpr VkQueue graphics_queue() const noexcept;
+        [[nodiscard]] VkFormat image_format() const noexcept override;
 
-        [[nodiscard]] constexpr VkFormat image_format() const noexcept;
+        [[nodiscard]] VkImageUsageFlags image_usage() const noexcept override;
 
-        [[nodiscard]] constexpr VkImage image(
-            uint32_t image_index) const noexcept;
+        [[nodiscard]] VkImage image(
+            uint32_t image_index) const noexcept override;
 
-        [[nodiscard]] constexpr VkImageView image_view(
-            uint32_t image_index) const noexcept;
+        [[nodiscard]] VkImageView image_view(
+            uint32_t image_index) const noexcept override;
+
+        [[nodiscard]] VkImageLayout final_layout() const noexcept override;
 
         [[nodiscard]] bool acquire_next_image(uint32_t current_frame,
-            uint32_t& image_index);
+            uint32_t& image_index) override;
 
         [[nodiscard]] bool submit_command_buffer(
             VkCommandBuffer const* command_buffer,
             uint32_t current_frame,
-            uint32_t image_index);
+            uint32_t image_index,
+            std::span<VkSemaphoreSubmitInfo const> wait_semaphores,
+            std::span<VkSemaphoreSubmitInfo const> signal_semaphores)
+            override;
 
         void resized();
 
@@ -105,6 +112,7 @@ namespace vkpong
         vulkan_context* context_{};
         vulkan_device* device_{};
         VkFormat image_format_{};
+        VkImageUsageFlags image_usage_{};
         VkExtent2D extent_{};
         VkSwapchainKHR chain{};
         std::vector<VkImage> images_;
@@ -119,35 +127,44 @@ namespace vkpong
 
 } // namespace vkpong
 
-inline constexpr VkExtent2D vkpong::vulkan_swap_chain::extent() const noexcept
+inline VkExtent2D vkpong::vulkan_swap_chain::extent() const noexcept
 {
     return extent_;
 }
 
-inline constexpr VkQueue
-vkpong::vulkan_swap_chain::graphics_queue() const noexcept
+inline VkQueue vkpong::vulkan_swap_chain::graphics_queue() const noexcept
 {
     return graphics_queue_;
 }
 
-inline constexpr VkFormat
-vkpong::vulkan_swap_chain::image_format() const noexcept
+inline VkFormat vkpong::vulkan_swap_chain::image_format() const noexcept
 {
     return image_format_;
 }
 
-inline constexpr VkImage vkpong::vulkan_swap_chain::image(
+inline VkImageUsageFlags
+vkpong::vulkan_swap_chain::image_usage() const noexcept
+{
+    return image_usage_;
+}
+
+inline VkImage vkpong::vulkan_swap_chain::image(
     uint32_t const image_index) const noexcept
 {
     return images_[image_index];
 }
 
-inline constexpr VkImageView vkpong::vulkan_swap_chain::image_view(
+inline VkImageView vkpong::vulkan_swap_chain::image_view(
     uint32_t const image_index) const noexcept
 {
     return image_views_[image_index];
 }
 
+inline VkImageLayout vkpong::vulkan_swap_chain::final_layout() const noexcept
+{
+    return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
 inline void vkpong::vulkan_swap_chain::resized()
 {
     framebuffer_resized_ = true;
@@ -1,27 +1,45 @@
 #include <vulkan_utility.hpp>
 
+#include <device_allocator.hpp>
+#include <host_allocator.hpp>
+#include <scope_exit.hpp>
+
+#include <bit>
+#include <functional>
+#include <limits>
 #include <stdexcept>
 
-uint32_t vkpong::find_memory_type(VkPhysicalDevice const physical_device,
+std::optional<uint32_t> vkpong::select_memory_type(
+    VkPhysicalDeviceMemoryProperties const& memory_properties,
     uint32_t const type_filter,
-    VkMemoryPropertyFlags const properties)
+    memory_preference const& preference)
 {
-    VkPhysicalDeviceMemoryProperties memory_properties;
-    vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties);
-    for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i)
+    std::optional<uint32_t> rv;
+    std::pair<int, int> best_score{};
+    for (uint32_t i{}; i != memory_properties.memoryTypeCount; ++i)
     {
-        if ((type_filter & (1 << i)) &&
-            (memory_properties.memoryTypes[i].propertyFlags & properties) ==
-                properties)
+        VkMemoryPropertyFlags const flags{
+            memory_properties.memoryTypes[i].propertyFlags};
+        if (!(type_filter & (1u << i)) ||
+            (flags & preference.required) != preference.required)
+        {
+            continue;
+        }
+
+        std::pair<int, int> const score{
+            std::popcount(flags & preference.preferred),
+            -std::popcount(flags & preference.avoided)};
+        if (!rv || score > best_score)
         {
-            return i;
+            rv = i;
+            best_score = score;
         }
     }
 
-    throw std::runtime_error{"failed to find suitable memory type!"};
+    return rv;
 }
 
-void vkpong::create_image(VkPhysicalDevice physical_device,
+void vkpong::create_image(device_allocator& allocator,
     VkDevice device,
     VkExtent2D extent,
     uint32_t mip_levels,
@@ -29,9 +47,9 @@ void vkpong::create_image(VkPhysicalDevice physical_device,
     VkFormat format,
     VkImageTiling tiling,
     VkImageUsageFlags usage,
-    VkMemoryPropertyFlags properties,
+    memory_preference const& memory,
     VkImage& image,
-    VkDeviceMemory& image_memory)
+    device_allocation& image_memory)
 {
     VkImageCreateInfo image_info{};
     image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -49,7 +67,10 @@ void vkpong::create_image(VkPhysicalDevice physical_device,
     image_info.samples = samples;
     image_info.flags = 0;
 
-    if (vkCreateImage(device, &image_info, nullptr, &image) != VK_SUCCESS)
+    if (vkCreateImage(device,
+            &image_info,
+            allocation_callbacks(),
+            &image) != VK_SUCCESS)
     {
         throw std::runtime_error{"failed to create image!"};
     }
@@ -57,23 +78,28 @@ void vkpong::create_image(VkPhysicalDevice physical_device,
     VkMemoryRequirements memory_requirements;
     vkGetImageMemoryRequirements(device, image, &memory_requirements);
 
-    VkMemoryAllocateInfo alloc_info{};
-    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    alloc_info.allocationSize = memory_requirements.size;
-    alloc_info.memoryTypeIndex = vkpong::find_memory_type(physical_device,
-        memory_requirements.memoryTypeBits,
-        properties);
-    if (vkAllocateMemory(device, &alloc_info, nullptr, &image_memory) !=
-        VK_SUCCESS)
+    try
+    {
+        image_memory = allocator.allocate(memory_requirements,
+            memory,
+            tiling == VK_IMAGE_TILING_LINEAR ? allocation_tiling::linear
+                                             : allocation_tiling::optimal,
+            allocation_category::image,
+            image);
+    }
+    catch (...)
     {
-        vkDestroyImage(device, image, nullptr);
-        throw std::runtime_error{"failed to allocate image memory!"};
+        vkDestroyImage(device, image, allocation_callbacks());
+        throw;
     }
 
-    if (vkBindImageMemory(device, image, image_memory, 0) != VK_SUCCESS)
+    if (vkBindImageMemory(device,
+            image,
+            image_memory.memory,
+            image_memory.offset) != VK_SUCCESS)
     {
-        vkFreeMemory(device, image_memory, nullptr);
-        vkDestroyImage(device, image, nullptr);
+        vkDestroyImage(device, image, allocation_callbacks());
+        allocator.free(image_memory);
         throw std::runtime_error{"failed to bind image memory!"};
     };
 }
@@ -97,11 +123,149 @@ VkImageView vkpong::create_image_view(VkDevice device,
     view_info.subresourceRange.layerCount = 1;
 
     VkImageView imageView{};
-    if (vkCreateImageView(device, &view_info, nullptr, &imageView) !=
-        VK_SUCCESS)
+    if (vkCreateImageView(device,
+            &view_info,
+            allocation_callbacks(),
+            &imageView) != VK_SUCCESS)
     {
         throw std::runtime_error{"failed to create image view!"};
     }
 
     return imageView;
 }
+
+VkSemaphore vkpong::create_semaphore(VkDevice const device)
+{
+    VkSemaphoreCreateInfo semaphore_info{};
+    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+    VkSemaphore rv{};
+    if (vkCreateSemaphore(device,
+            &semaphore_info,
+            allocation_callbacks(),
+            &rv) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to create semaphore"};
+    }
+
+    return rv;
+}
+
+VkSemaphore vkpong::create_timeline_semaphore(VkDevice const device,
+    uint64_t const initial_value)
+{
+    VkSemaphoreTypeCreateInfo type_info{};
+    type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    type_info.initialValue = initial_value;
+
+    VkSemaphoreCreateInfo semaphore_info{};
+    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphore_info.pNext = &type_info;
+
+    VkSemaphore rv{};
+    if (vkCreateSemaphore(device,
+            &semaphore_info,
+            allocation_callbacks(),
+            &rv) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to create timeline semaphore"};
+    }
+
+    return rv;
+}
+
+VkFence vkpong::create_fence(VkDevice const device, bool const set_signaled)
+{
+    VkFenceCreateInfo fence_info{};
+    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if (set_signaled)
+    {
+        fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    }
+
+    VkFence rv{};
+    if (vkCreateFence(device,
+            &fence_info,
+            allocation_callbacks(),
+            &rv) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to create fence"};
+    }
+
+    return rv;
+}
+
+void vkpong::submit_one_time(VkDevice const device,
+    uint32_t const queue_family,
+    VkQueue const queue,
+    std::function<void(VkCommandBuffer)> const& record)
+{
+    VkCommandPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    pool_info.queueFamilyIndex = queue_family;
+
+    VkCommandPool command_pool{};
+    if (vkCreateCommandPool(device,
+            &pool_info,
+            allocation_callbacks(),
+            &command_pool) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to create command pool!"};
+    }
+    VKPONG_ON_SCOPE_EXIT(vkDestroyCommandPool(device,
+        command_pool,
+        allocation_callbacks()));
+
+    VkCommandBufferAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    alloc_info.commandPool = command_pool;
+    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    alloc_info.commandBufferCount = 1;
+
+    VkCommandBuffer command_buffer{};
+    if (vkAllocateCommandBuffers(device, &alloc_info, &command_buffer) !=
+        VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to allocate command buffers!"};
+    }
+
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(command_buffer, &begin_info) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"unable to begin command buffer recording!"};
+    }
+
+    record(command_buffer);
+
+    if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"unable to end command buffer recording!"};
+    }
+
+    VkFence const fence{create_fence(device, false)};
+    VKPONG_ON_SCOPE_EXIT(vkDestroyFence(device, fence, allocation_callbacks()));
+
+    VkCommandBufferSubmitInfo command_buffer_info{};
+    command_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+    command_buffer_info.commandBuffer = command_buffer;
+
+    VkSubmitInfo2 submit_info{};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+    submit_info.commandBufferInfoCount = 1;
+    submit_info.pCommandBufferInfos = &command_buffer_info;
+
+    if (vkQueueSubmit2(queue, 1, &submit_info, fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error{"failed to submit command buffer!"};
+    }
+
+    vkWaitForFences(device,
+        1,
+        &fence,
+        VK_TRUE,
+        std::numeric_limits<uint64_t>::max());
+}
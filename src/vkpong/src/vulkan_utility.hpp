@@ -6,6 +6,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <optional>
 #include <span>
 #include <utility>
@@ -13,9 +14,55 @@
 
 namespace vkpong
 {
-    [[nodiscard]] uint32_t find_memory_type(VkPhysicalDevice physical_device,
+    class device_allocator;
+    struct device_allocation;
+} // namespace vkpong
+
+namespace vkpong
+{
+    // Required flags must all be present. Among the types that have them
+    // the one with the most preferred flags wins, ties are broken by the
+    // fewest avoided flags and then by the driver's ordering of types.
+    struct [[nodiscard]] memory_preference final
+    {
+        VkMemoryPropertyFlags required{};
+        VkMemoryPropertyFlags preferred{};
+        VkMemoryPropertyFlags avoided{};
+    };
+
+    // Resources only accessed by the device. Host visible device local
+    // memory is limited on discrete devices without resizable BAR.
+    inline constexpr memory_preference device_local_memory{
+        .required = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        .avoided = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+            VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT};
+
+    // Host visible memory doesn't have to be coherent, writes are flushed
+    // and device writes are invalidated explicitly.
+
+    // Written once by the host and copied from by the device.
+    inline constexpr memory_preference staging_memory{
+        .required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+        .avoided = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+            VK_MEMORY_PROPERTY_HOST_CACHED_BIT};
+
+    // Written by the host every frame and read directly by the device,
+    // device local when the device exposes host visible device memory.
+    // Write combined memory is preferred as the host never reads it.
+    inline constexpr memory_preference dynamic_memory{
+        .required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+        .preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        .avoided = VK_MEMORY_PROPERTY_HOST_CACHED_BIT};
+
+    // Written by the device and read by the host.
+    inline constexpr memory_preference readback_memory{
+        .required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+        .preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT};
+
+    [[nodiscard]] std::optional<uint32_t> select_memory_type(
+        VkPhysicalDeviceMemoryProperties const& memory_properties,
         uint32_t type_filter,
-        VkMemoryPropertyFlags properties);
+        memory_preference const& preference);
 
     template<typename T>
     [[nodiscard]] constexpr uint32_t count_cast(T const count)
@@ -41,7 +88,7 @@ namespace vkpong
             elements.value_or(value.size()) * sizeof(T)};
     }
 
-    void create_image(VkPhysicalDevice physical_device,
+    void create_image(device_allocator& allocator,
         VkDevice device,
         VkExtent2D extent,
         uint32_t mip_levels,
@@ -49,15 +96,29 @@ namespace vkpong
         VkFormat format,
         VkImageTiling tiling,
         VkImageUsageFlags usage,
-        VkMemoryPropertyFlags properties,
+        memory_preference const& memory,
         VkImage& image,
-        VkDeviceMemory& image_memory);
+        device_allocation& image_memory);
 
     [[nodiscard]] VkImageView create_image_view(VkDevice device,
         VkImage image,
         VkFormat format,
         VkImageAspectFlags aspect_flags,
         uint32_t mip_levels);
+
+    [[nodiscard]] VkSemaphore create_semaphore(VkDevice device);
+
+    [[nodiscard]] VkSemaphore create_timeline_semaphore(VkDevice device,
+        uint64_t initial_value);
+
+    [[nodiscard]] VkFence create_fence(VkDevice device, bool set_signaled);
+
+    // Records commands into a temporary command buffer, submits it and
+    // waits for its completion.
+    void submit_one_time(VkDevice device,
+        uint32_t queue_family,
+        VkQueue queue,
+        std::function<void(VkCommandBuffer)> const& record);
 } // namespace vkpong
 
 #endif // !VKPONG_VULKAN_UTILITY_INCLUDED